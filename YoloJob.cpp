@@ -1,271 +1,872 @@
 #include <iostream>
 #include <string>
-#include <queue>
+#include <memory>
 #include <thread>
 #include <mutex>
-#include <chrono>
 #include <condition_variable>
-#include <future>
+#include <chrono>
 #include <csignal>
+#include <future>
 #include <atomic>
+#include <algorithm>
 #include "include/Detect.h"
+#include "include/BYTETracker.h"
+#include "include/FramePool.h"
+#include "include/Pipeline.h"
+#include "include/ReorderBuffer.h"
+#include "include/FairScheduler.h"
+#include "include/TaskPool.h"
+#include "include/ResultSink.h"
+#include "include/VideoSource.h"
+#include "include/AsyncWriter.h"
+#include "include/BatchController.h"
 
 /**
  * @brief 作业结构体
- * 
- * 用于在生产者和消费者之间传递数据的结构体，
- * 包含输入图像和用于返回结果的期对象
+ *
+ * 在流水线各级之间传递的数据，
+ * 包含所属视频流、帧序号、输入图像（帧池槽位引用）和各级的中间结果
  */
 struct Job
 {
-    cv::Mat inputImage;                              ///< 输入图像
-    std::shared_ptr<std::promise<cv::Mat>> outputImage; ///< 输出图像期对象
+    int stream = 0;                                      ///< 视频流序号
+    int64_t sequence = 0;                                ///< 帧序号（每路视频流独立编号）
+    std::chrono::steady_clock::time_point captured;      ///< 解码完成时刻（用于统计端到端延迟）
+    cv::Mat signature;                                   ///< 亮度特征（静止画面门控，调度后释放）
+    bool reused = false;                                 ///< 复用上一推理帧的结果（跳过预处理、推理和后处理）
+    FrameRef inputImage;                                 ///< 输入图像
+    Transformer transformer;                             ///< 预处理结果（含模型输入矩阵）
+    vector<cv::Mat> outputs;                             ///< 模型原始输出
+    vector<cv::Rect> rects;                              ///< 检测框
+    vector<string> names;                                ///< 类别名称
+    vector<float> confidences;                           ///< 置信度
+    vector<STrack> tracks;                               ///< 跟踪结果
+};
+
+/**
+ * @brief 视频流结构体
+ *
+ * 每路视频流独立解码、独立编号和按序输出，共享同一条推理流水线
+ */
+struct Stream
+{
+    int id = 0;                                          ///< 视频流序号
+    string videoPath;                                    ///< 输入视频路径
+    string savePath;                                     ///< 输出视频路径（可选）
+    VideoSource source;                                  ///< 视频源（FFmpeg多线程解码）
+    cv::Size sourceSize;                                 ///< 原始分辨率（检测结果所在的坐标系）
+    std::unique_ptr<FramePool> framePool;                ///< 帧缓冲池（需先于重排缓冲和写入器定义，保证其中的帧引用先析构）
+    std::unique_ptr<AsyncWriter<Job>> writer;            ///< 异步视频写入器（可选）
+    std::unique_ptr<ReorderBuffer<Job>> results;         ///< 结果重排缓冲
+    std::unique_ptr<ReorderBuffer<Job>> trackOrder;      ///< 跟踪重排缓冲
+    std::unique_ptr<BYTETracker> tracker;                ///< 跟踪器
+    double gateThreshold = 0.0;                          ///< 静止画面门控阈值（亮度特征平均绝对差，0表示不门控）
+    int gateRefresh = 0;                                 ///< 连续复用的最大帧数（强制刷新间隔，0表示不限）
+    cv::Size gateSize;                                   ///< 亮度特征尺寸
+    cv::Mat gateSignature;                               ///< 上一推理帧的亮度特征（仅调度线程访问）
+    int gateReused = 0;                                  ///< 距上一推理帧已连续复用的帧数（仅调度线程访问）
+    vector<cv::Rect> lastRects;                          ///< 上一推理帧的检测框（仅按序级访问）
+    vector<string> lastNames;                            ///< 上一推理帧的类别名称
+    vector<float> lastConfidences;                       ///< 上一推理帧的置信度
+    int64_t reusedFrames = 0;                            ///< 复用结果的帧数
+    size_t node = 0;                                     ///< 所属执行节点（nodes 下标）
+    size_t slot = 0;                                     ///< 在所属节点调度器中的队列号
+    int64_t nextSequence = 0;                            ///< 下一个帧序号（仅调度线程访问）
+    int64_t frames = 0;                                  ///< 已读取帧数
 };
 
-// 共享队列
-std::queue<Job> jobs;
-// 互斥锁
-std::mutex mutex_lock;
-// 条件变量
-std::condition_variable condition_v;
-// 结束标记符
-std::atomic<bool> finished(false);
+/**
+ * @brief 执行节点结构体
+ *
+ * 每个NUMA节点一份推理引擎、调度器、线程池和流水线，分配到该节点的视频流只在本节点内处理，
+ * 解码、CPU级和ORT线程绑定到本节点的CPU，帧缓冲和模型权重由本节点的线程首次写入（节点本地分配）。
+ * 未启用NUMA时只有一个节点，CPU集合为空表示不绑定。
+ */
+struct Node
+{
+    int id = 0;                                          ///< NUMA节点编号
+    vector<int> cpus;                                    ///< 节点的全部CPU（为空表示不绑定）
+    vector<int> decodeCpus;                              ///< 解码线程绑定的CPU
+    vector<int> poolCpus;                                ///< CPU级线程绑定的CPU
+    vector<int> ortCpus;                                 ///< ORT计算线程绑定的CPU（为空时沿用加载线程的绑定）
+    vector<size_t> streamIds;                            ///< 分配到本节点的视频流（下标即调度器中的队列号）
+    int64_t loadMs = 0;                                  ///< 模型加载耗时
+    int64_t warmupMs = 0;                                ///< 模型预热耗时
+    std::unique_ptr<Detect> engine;                      ///< 推理引擎
+    std::unique_ptr<FairScheduler<Job>> scheduler;       ///< 多路输入调度器：每路一个接收队列，按轮询或差额轮询送入流水线
+    std::unique_ptr<TaskPool> taskPool;                  ///< CPU级共享的工作窃取线程池（需在流水线之前定义，保证流水线线程先退出）
+    std::unique_ptr<BatchController> batcher;            ///< 推理级自适应批量控制器（可选，需在流水线之前定义）
+    std::unique_ptr<Pipeline<Job>> pipeline;             ///< 处理流水线：预处理 -> 推理 -> 后处理 -> [跟踪] -> [绘制] -> 输出
+};
+
+// 各路视频流（需在执行节点之前定义，保证其中残留的帧引用先析构）
+std::vector<std::unique_ptr<Stream>> streams;
+// 执行节点
+std::vector<std::unique_ptr<Node>> nodes;
+// 逐帧检测结果输出（可选，无界面运行时代替显示）
+std::unique_ptr<ResultSink> resultSink;
+// 结果输出写入失败（如管道读端已关闭）后不再写入
+std::atomic<bool> sink_failed(false);
+// 无界面模式：不创建窗口、不叠加FPS
+bool headless = false;
+
+/**
+ * @brief 待显示的结果帧
+ *
+ * HighGUI不是线程安全的：各路显示线程只提交最新结果（覆盖未显示的旧帧），
+ * 由单个界面线程统一调用 imshow/waitKey
+ */
+struct GuiFrames
+{
+    std::mutex mutex;                   ///< 保护以下成员
+    std::condition_variable ready;      ///< 有新帧或已关闭
+    std::vector<cv::Mat> latest;        ///< 各路最新结果（下标为视频流序号）
+    std::vector<bool> fresh;            ///< 各路最新结果是否尚未显示
+    bool closed = false;                ///< 不再提交新帧
+};
+GuiFrames gui_frames;
 // 中断标记符
 std::atomic<bool> interrupted(false);
-// 加载延迟时间
-const int load_delay = 20;
+// 进程启动时刻，用于统计启动耗时和首帧延迟
+const std::chrono::steady_clock::time_point startup_begin = std::chrono::steady_clock::now();
+
+/**
+ * @brief 距进程启动的毫秒数
+ */
+int64_t elapsed_ms(std::chrono::steady_clock::time_point since = startup_begin)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since).count();
+}
 
 /**
  * @brief 信号处理函数
- * 
+ *
  * 处理中断信号（如Ctrl+C），安全地关闭程序
- * 
+ *
  * @param signal 信号编号
  */
 void signal_handler(int signal)
 {
     std::cout << "接收到信号 " << signal << ", 准备退出..." << std::endl;
     interrupted.store(true);
+    // 关闭各级队列，唤醒所有 生产者和工作线程 退出
+    for (const std::unique_ptr<Node> &node : nodes)
     {
-        std::unique_lock<std::mutex> lock(mutex_lock);
-        finished.store(true);
+        if (node->scheduler)
+        {
+            node->scheduler->close();
+        }
+        if (node->pipeline)
+        {
+            node->pipeline->abort();
+        }
+    }
+    for (const std::unique_ptr<Stream> &stream : streams)
+    {
+        // 打开视频流期间收到信号时该路尚未分配
+        if (stream->results)
+        {
+            stream->results->close();
+        }
+        if (stream->framePool)
+        {
+            stream->framePool->close();
+        }
     }
-    // 通知所有 生产者和消费者 退出
-    condition_v.notify_all();
 }
 
 /**
- * @brief 显示处理结果
- * 
- * 显示处理后的视频帧，计算并显示FPS，并将结果写入视频文件（如果指定）
- * 
- * @param futures 包含处理结果的期对象向量
- * @param frameCount 帧计数器
- * @param start 开始时间点
- * @param writer 视频写入器
+ * @brief 读取整数参数
+ *
+ * @param paramMap 参数表
+ * @param key 参数名
+ * @param defaultValue 参数缺省时的默认值
+ * @return int 参数值
+ */
+int param_int(unordered_map<string, string> &paramMap, const string &key, int defaultValue)
+{
+    return paramMap.count(key) ? std::stoi(paramMap[key]) : defaultValue;
+}
+
+/**
+ * @brief 生成多路输出时每路的输出文件名
+ *
+ * @param save_path 输出视频路径
+ * @param id 视频流序号
+ * @return string 在扩展名前加上 _序号 的路径
+ */
+string stream_save_path(const string &save_path, int id)
+{
+    size_t dot = save_path.find_last_of('.');
+    size_t slash = save_path.find_last_of('/');
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+    {
+        return save_path + "_" + std::to_string(id);
+    }
+    return save_path.substr(0, dot) + "_" + std::to_string(id) + save_path.substr(dot);
+}
+
+/**
+ * @brief 解析尺寸参数
+ *
+ * @param value 形如 "640x640" 或 "640" 的尺寸，空字符串表示不设置
+ * @return cv::Size 尺寸
+ */
+cv::Size parse_size(const string &value)
+{
+    if (value.empty())
+    {
+        return cv::Size();
+    }
+    size_t x = value.find('x');
+    if (x == string::npos)
+    {
+        int side = std::stoi(value);
+        return cv::Size(side, side);
+    }
+    return cv::Size(std::stoi(value.substr(0, x)), std::stoi(value.substr(x + 1)));
+}
+
+/**
+ * @brief 将原始分辨率下的框映射到解码输出的图像上
+ *
+ * @param box 原始分辨率下的框
+ * @param image 解码输出的图像
+ * @param sourceSize 原始分辨率
+ * @return cv::Rect 图像上的框
+ */
+cv::Rect to_image_rect(const cv::Rect &box, const cv::Mat &image, const cv::Size &sourceSize)
+{
+    if (image.size() == sourceSize)
+    {
+        return box;
+    }
+    double sx = static_cast<double>(image.cols) / sourceSize.width;
+    double sy = static_cast<double>(image.rows) / sourceSize.height;
+    return cv::Rect(static_cast<int>(box.x * sx), static_cast<int>(box.y * sy),
+                    static_cast<int>(box.width * sx), static_cast<int>(box.height * sy));
+}
+
+/**
+ * @brief 计算静止画面门控的亮度特征
+ *
+ * @param image 解码输出的图像（BGR）
+ * @param size 特征尺寸
+ * @return cv::Mat 缩小后的灰度图
+ */
+cv::Mat gate_signature(const cv::Mat &image, const cv::Size &size)
+{
+    cv::Mat small, gray;
+    // 区域平均缩小同时抑制噪声，缩小后再转灰度
+    cv::resize(image, small, size, 0, 0, cv::INTER_AREA);
+    cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+    return gray;
+}
+
+/**
+ * @brief 静止画面门控：决定作业是否复用上一推理帧的结果（按帧序在调度线程中调用）
+ *
+ * 与上一推理帧的亮度特征平均绝对差低于阈值时复用，连续复用达到强制刷新间隔时重新推理
+ *
+ * @param stream 视频流
+ * @param job 作业
  */
-void display(std::vector<std::future<cv::Mat>> &futures,
-             int &frameCount,
-             std::chrono::_V2::system_clock::time_point &start,
-             cv::VideoWriter &writer)
+void gate_job(Stream &stream, Job &job)
 {
-    for (auto &future : futures)
+    if (job.signature.empty())
     {
-        if (future.valid())
+        return;
+    }
+    bool reuse = false;
+    if (!stream.gateSignature.empty() && (stream.gateRefresh <= 0 || stream.gateReused < stream.gateRefresh))
+    {
+        double diff = cv::norm(job.signature, stream.gateSignature, cv::NORM_L1) / job.signature.total();
+        reuse = diff < stream.gateThreshold;
+    }
+    if (reuse)
+    {
+        job.reused = true;
+        stream.gateReused++;
+        stream.reusedFrames++;
+    }
+    else
+    {
+        stream.gateSignature = job.signature;
+        stream.gateReused = 0;
+    }
+    job.signature.release();
+}
+
+/**
+ * @brief 读取按路配置的参数
+ *
+ * @param paramMap 参数表
+ * @param key 参数名（逗号分隔的每路取值，只有一个值时用于所有路）
+ * @param count 视频流数量
+ * @param defaultValue 参数缺省时的默认值
+ * @return vector<double> 每路的取值
+ */
+vector<double> param_per_stream(unordered_map<string, string> &paramMap, const string &key, size_t count, double defaultValue)
+{
+    vector<double> values(count, defaultValue);
+    if (!paramMap.count(key))
+    {
+        return values;
+    }
+    vector<string> items = stringSplit(paramMap[key], ",");
+    for (size_t i = 0; i < count; i++)
+    {
+        if (items.size() == 1)
         {
-            cv::Mat result = future.get();
-            frameCount++;
-            std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
-            double fps = frameCount / elapsed.count();
+            values[i] = std::stod(items[0]);
+        }
+        else if (i < items.size() && !items[i].empty())
+        {
+            values[i] = std::stod(items[i]);
+        }
+    }
+    return values;
+}
 
-            std::string fpsString = "FPS: " + std::to_string((int)fps);
-            cv::putText(result, fpsString, cv::Point(result.cols - 150, 30), cv::FONT_HERSHEY_SIMPLEX, 1, cv::Scalar(0, 255, 0), 2);
-            // 写入文件
-            if (writer.isOpened()){
-                writer.write(result);
-            }
-            cv::imshow("yolo", result);
-            cv::waitKey(1);
+/**
+ * @brief 确定节点上某类线程绑定的CPU
+ *
+ * @param cpus 配置的CPU（全局编号）
+ * @param node 执行节点
+ * @param what 线程类别（用于提示）
+ * @return vector<int> 未启用NUMA时为配置值；启用时为配置值与节点CPU的交集，
+ *         未配置或交集为空时为节点的全部CPU
+ */
+vector<int> node_cpus(const vector<int> &cpus, const Node &node, const string &what)
+{
+    if (node.cpus.empty() || cpus.empty())
+    {
+        return cpus.empty() ? node.cpus : cpus;
+    }
+    vector<int> local = intersectCpus(cpus, node.cpus);
+    if (local.empty())
+    {
+        std::cerr << "Warning: " << what << " has no cpu on numa node " << node.id << ", using all cpus of the node" << std::endl;
+        return node.cpus;
+    }
+    return local;
+}
+
+/**
+ * @brief 输出视频的编码选项
+ */
+struct EncodeOptions
+{
+    size_t queue = 8;                                    ///< 待编码队列容量
+    bool drop = false;                                   ///< 队列满时丢弃最旧的帧（否则阻塞显示线程）
+    double scale = 1.0;                                  ///< 输出缩放比例
+    AsyncWriter<Job>::Overlay overlay;                   ///< 编码线程中的叠加绘制（为空表示帧已由绘制级绘制）
+};
+
+/**
+ * @brief 在图像上绘制检测框或跟踪框
+ *
+ * 检测结果位于原始分辨率坐标系，图像为解码缩放或预览缩小后的尺寸时按比例映射
+ *
+ * @param job 作业
+ * @param image 目标图像
+ * @param stream 作业所属的视频流（原始分辨率和跟踪框颜色）
+ * @param tracks 是否绘制跟踪结果（否则绘制检测结果）
+ */
+void draw_job(const Job &job, cv::Mat &image, Stream &stream, bool tracks)
+{
+    const cv::Size &sourceSize = stream.sourceSize;
+    if (tracks)
+    {
+        // 绘制跟踪框和跟踪ID
+        for (const STrack &track : job.tracks)
+        {
+            // tlwh 与 static_tlbr() 换算出的框一致，只读访问不修改作业
+            cv::Rect box = to_image_rect(cv::Rect(track.tlwh[0], track.tlwh[1], track.tlwh[2], track.tlwh[3]), image, sourceSize);
+            cv::Scalar color = stream.tracker->get_color(track.track_id);
+            cv::rectangle(image, box, color, 2, 8);
+            cv::putText(image, std::to_string(track.track_id), cv::Point(box.x, box.y - 10), cv::FONT_HERSHEY_SIMPLEX, 0.5, color, 2);
         }
+        return;
+    }
+    for (size_t i = 0; i < job.rects.size(); i++)
+    {
+        cv::Rect box = to_image_rect(job.rects.at(i), image, sourceSize);
+        cv::rectangle(image, box, cv::Scalar(0, 0, 255), 2, 8);
+        putText(image, job.names.at(i) + std::to_string(job.confidences.at(i)), cv::Point(box.x + 10, box.y + 10), cv::FONT_HERSHEY_SIMPLEX, 1, cv::Scalar(0, 255, 0), 2);
     }
 }
 
 /**
- * @brief 视频捕获和生产者函数
- * 
- * 从视频文件读取帧，将其作为作业放入队列供消费者处理
- * 
- * @param video_path 输入视频路径
- * @param save_path 输出视频路径（可选）
- * @param consumer_n 消费者线程数量
- * @param limit 队列最大容量限制
+ * @brief 打开视频流并分配该路的帧池、重排缓冲和跟踪器
+ *
+ * @param stream 视频流（需已设置 id 和 videoPath）
+ * @param options 解码选项（options.outputSize 为letterbox目标尺寸，为空表示按原始分辨率解码）
+ * @param output_path 输出视频路径，为空表示不输出
+ * @param encode 输出视频的编码选项
+ * @param multi 是否为多路输入（输出文件名加序号）
+ * @param pool_size 帧池大小（同时作为重排窗口）
+ * @param track_buffer 跟踪器丢失目标的保留帧数
+ * @return bool 打开失败返回false
  */
-void capture(const string& video_path, const string& save_path, const int& consumer_n, const int& limit)
+bool open_stream(Stream &stream, VideoSource::Options options, const string &output_path, const EncodeOptions &encode, bool multi, int pool_size, int track_buffer)
 {
-    // 设置信号处理
-    struct sigaction sigIntHandler;
-    sigIntHandler.sa_handler = signal_handler;
-    sigemptyset(&sigIntHandler.sa_mask);
-    sigIntHandler.sa_flags = 0;
-    sigaction(SIGINT, &sigIntHandler, NULL);
-    sigaction(SIGTSTP, &sigIntHandler, NULL);
+    // 打开后按原始分辨率和letterbox目标尺寸确定解码输出尺寸
+    cv::Size letterbox = options.outputSize;
+    options.outputSize = cv::Size();
+    if (!stream.source.open(stream.videoPath, options))
+    {
+        return false;
+    }
+    stream.sourceSize = stream.source.getSourceSize();
+    if (letterbox.area() > 0)
+    {
+        stream.source.setOutputSize(letterboxSize(stream.sourceSize, letterbox));
+    }
+    // 获取视频的帧率和解码输出的宽度、高度
+    double fps = stream.source.getFps();
+    int width = stream.source.getOutputSize().width;
+    int height = stream.source.getOutputSize().height;
+    if (!output_path.empty())
+    {
+        // 使用 H.264 编码器
+        int fourcc = cv::VideoWriter::fourcc('a', 'v', 'c', '1');
+        stream.savePath = multi ? stream_save_path(output_path, stream.id) : output_path;
+        stream.writer.reset(new AsyncWriter<Job>(encode.queue, encode.drop ? OVERLOAD_DROP_OLDEST : OVERLOAD_BLOCK));
+        if (!stream.writer->open(stream.savePath, fourcc, fps, cv::Size(width, height), encode.scale,
+                                 [](Job &job) -> cv::Mat & { return job.inputImage.image(); }, encode.overlay))
+        {
+            std::cerr << "Error: Could not create video writer for " << stream.savePath << std::endl;
+            stream.writer.reset();
+        }
+    }
+    stream.framePool.reset(new FramePool(pool_size, width, height));
+    stream.results.reset(new ReorderBuffer<Job>(pool_size));
+    stream.trackOrder.reset(new ReorderBuffer<Job>(pool_size));
+    stream.tracker.reset(new BYTETracker(fps > 0 ? static_cast<int>(fps) : 30, track_buffer));
+    return true;
+}
 
+/**
+ * @brief 显示处理结果
+ *
+ * 在独立线程中按帧序号从该路的重排缓冲取出结果：下一帧一旦就绪立即叠加FPS并提交给界面线程，
+ * 不阻塞生产者读帧，并将结果写入视频文件（如果指定）。
+ * 结果输出打开时按帧序写出检测和跟踪结果；无界面模式下只输出结果和视频文件
+ *
+ * @param stream 视频流
+ */
+void display(Stream &stream)
+{
     auto start = std::chrono::high_resolution_clock::now();
     int frameCount = 0;
-    cv::VideoCapture cap(video_path);
-
-    // 获取视频的帧率、宽度和高度
-    double fps = cap.get(cv::CAP_PROP_FPS);
-    int width = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH));
-    int height = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
-
-    // 使用 H.264 编码器
-    int fourcc = cv::VideoWriter::fourcc('a', 'v', 'c', '1'); // H.264 编码器
+    BatchController *batcher = nodes[stream.node]->batcher.get();
+    Job job;
+    while (stream.results->pop(job))
+    {
+        cv::Mat &result = job.inputImage.image();
+        if (frameCount == 0)
+        {
+            std::cout << "stream " << stream.id << " 首帧输出 " << elapsed_ms() << " ms" << std::endl;
+        }
+        frameCount++;
+        if (batcher)
+        {
+            batcher->recordLatency(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - job.captured).count());
+        }
+        if (resultSink && !sink_failed.load() &&
+            !resultSink->write(stream.id, job.sequence, job.rects, job.names, job.confidences, job.tracks) &&
+            !sink_failed.exchange(true))
+        {
+            std::cerr << "结果输出写入失败（管道读端可能已关闭），之后的结果不再输出，已写入 "
+                      << resultSink->getWritten() << " 帧" << std::endl;
+        }
+        if (!headless)
+        {
+            std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+            double fps = frameCount / elapsed.count();
 
-    cv::VideoWriter writer;
-    if (!save_path.empty()) { 
-        writer.open(save_path, fourcc, fps, cv::Size(width, height));
+            std::string fpsString = "FPS: " + std::to_string((int)fps);
+            cv::putText(result, fpsString, cv::Point(result.cols - 150, 30), cv::FONT_HERSHEY_SIMPLEX, 1, cv::Scalar(0, 255, 0), 2);
+            // 复制到该路的显示缓冲（尺寸不变时复用），帧池槽位照常归还
+            std::lock_guard<std::mutex> lock(gui_frames.mutex);
+            result.copyTo(gui_frames.latest[stream.id]);
+            gui_frames.fresh[stream.id] = true;
+            gui_frames.ready.notify_one();
+        }
+        // 交给编码线程写入文件（队列满时按配置阻塞或丢弃最旧的帧），帧引用在编码完成后释放
+        if (stream.writer)
+        {
+            stream.writer->write(std::move(job));
+        }
+        // 显示完后释放引用，槽位归还帧池
+        job = Job();
     }
+    std::cout << "显示退出 " << stream.id << " " << frameCount << std::endl;
+}
 
-    cv::Mat frame;
-    std::vector<std::future<cv::Mat>> futures;
-    while (cap.read(frame) && !interrupted.load())
+/**
+ * @brief 界面线程
+ *
+ * 唯一调用 imshow/waitKey 的线程：显示各路提交的最新结果，关闭后销毁窗口
+ */
+void gui_loop()
+{
+    std::vector<cv::Mat> shown(gui_frames.latest.size());
+    while (true)
     {
-        Job job;
+        std::vector<size_t> updated;
         {
-            std::unique_lock<std::mutex> lock(mutex_lock);
-            // 等待队列未满或生产完成
-            condition_v.wait(lock, [&]() -> bool
-                             { return jobs.size() < limit || finished.load() || interrupted.load(); });
-            
-            if (finished.load() || interrupted.load()) {
+            std::unique_lock<std::mutex> lock(gui_frames.mutex);
+            // 定期醒来处理窗口事件
+            gui_frames.ready.wait_for(lock, std::chrono::milliseconds(30), [] {
+                return gui_frames.closed || std::find(gui_frames.fresh.begin(), gui_frames.fresh.end(), true) != gui_frames.fresh.end();
+            });
+            for (size_t i = 0; i < gui_frames.fresh.size(); i++)
+            {
+                if (gui_frames.fresh[i])
+                {
+                    gui_frames.latest[i].copyTo(shown[i]);
+                    gui_frames.fresh[i] = false;
+                    updated.push_back(i);
+                }
+            }
+            if (gui_frames.closed && updated.empty())
+            {
                 break;
             }
-
-            // 深拷贝
-            job.inputImage = frame.clone();
-            job.outputImage.reset(new std::promise<cv::Mat>());
-            jobs.push(job);
-            futures.push_back(job.outputImage->get_future());
         }
-        // 通知消费者
-        condition_v.notify_all();
-        // 生产者最大等待数目
-        if (futures.size() >= consumer_n + 2)
+        for (size_t i : updated)
         {
-            // 显示
-            display(futures, frameCount, start, writer);
-            futures.clear();
+            cv::imshow("yolo_" + std::to_string(i), shown[i]);
         }
+        cv::waitKey(1);
     }
-    // 最后几张图片显示
-    for (auto &future : futures)
+    cv::destroyAllWindows();
+}
+
+/**
+ * @brief 视频捕获和生产者函数
+ *
+ * 在该路自己的线程中读取帧，按过载策略放入该路的接收队列
+ *
+ * @param stream 视频流
+ */
+void capture(Stream &stream)
+{
+    FairScheduler<Job> &scheduler = *nodes[stream.node]->scheduler;
+    pinCurrentThread(nodes[stream.node]->decodeCpus);
+    while (!interrupted.load())
     {
-        display(futures, frameCount, start, writer);
+        // 解码直接写入空闲槽位（尺寸一致时 read 复用已分配的缓冲）
+        FrameRef frame = stream.framePool->acquire();
+        if (frame.empty() || !stream.source.read(frame.image()))
+        {
+            break;
+        }
+        stream.frames++;
+        Job job;
+        job.stream = stream.id;
+        job.captured = std::chrono::steady_clock::now();
+        if (stream.gateThreshold > 0)
+        {
+            // 特征在各路的解码线程中计算，调度线程只做比较
+            job.signature = gate_signature(frame.image(), stream.gateSize);
+        }
+        job.inputImage = std::move(frame);
+        // 接收队列满时按过载策略阻塞或丢帧（被丢弃的帧槽位立即归还），被中断时退出
+        if (!scheduler.offer(stream.slot, std::move(job)))
+        {
+            break;
+        }
     }
-    futures.clear();
+    scheduler.closeStream(stream.slot);
+    std::cout << "生产者退出 " << stream.id << " " << stream.frames << std::endl;
+}
+
+/**
+ * @brief 调度函数
+ *
+ * 每个节点一个调度线程，按调度方式从本节点各路接收队列取帧，分配该路的帧序号后送入本节点的流水线。
+ * 被过载策略丢弃的帧不占序号；每路在途帧数受其帧池限制，不会超出重排窗口。
+ *
+ * @param node 执行节点
+ */
+void schedule(Node &node)
+{
+    Job job;
+    size_t slot = 0;
+    while (node.scheduler->next(job, slot))
     {
-        // 标记已经完成
-        std::cout << "生产者退出 " << frameCount << std::endl;
-        std::unique_lock<std::mutex> lock(mutex_lock);
-        finished.store(true);
-    }
-    // 释放
-    cap.release();
-    if (writer.isOpened()){
-        writer.release();
+        Stream &stream = *streams[node.streamIds[slot]];
+        if (!stream.results->waitForSlot(stream.nextSequence))
+        {
+            break;
+        }
+        job.sequence = stream.nextSequence++;
+        // 门控在过载丢帧之后按帧序进行，比较对象总是实际进入推理的上一帧
+        gate_job(stream, job);
+        bool reused = job.reused;
+        // 流水线第一级队列满时阻塞，下游按批次混合各路的帧
+        if (!node.pipeline->push(std::move(job)))
+        {
+            break;
+        }
+        if (node.batcher && !reused)
+        {
+            node.batcher->recordArrival();
+        }
     }
-    cv::destroyAllWindows();
-    // 通知消费者
-    condition_v.notify_all();
+    // 输入全部结束，流水线处理完已送入的帧后逐级退出
+    node.pipeline->close();
 }
 
 /**
- * @brief 推理消费者函数
- * 
- * 从作业队列中获取图像，使用YOLO模型进行目标检测，并将结果返回
- * 
- * @param id 消费者线程ID
- * @param model_dir 模型目录路径
+ * @brief 打印各路视频流的调度和丢帧统计
  */
-void infer(const int& id, const string& model_dir)
+void report_streams()
 {
-    // 避免同时启动 (瞬时的gpu显存占用过多)
-    std::this_thread::sleep_for(std::chrono::seconds(id * load_delay));
-    Detect detect(model_dir);
-    // 预热
-    detect.warmup();
-    while (!interrupted.load())
+    for (const std::unique_ptr<Stream> &stream : streams)
     {
-        std::unique_lock<std::mutex> lock(mutex_lock);
-        // 等待队列非空或者生产完成
-        condition_v.wait(lock, [&]() -> bool
-                         { return !jobs.empty() || finished.load() || interrupted.load(); });
-        // 如果生产完成且队列为空，则退出
-        if ((finished.load() && jobs.empty()) || interrupted.load())
+        const Node &node = *nodes[stream->node];
+        const IngestQueue<Job> &queue = node.scheduler->getQueue(stream->slot);
+        std::cout << "stream " << stream->id
+                  << " node=" << node.id
+                  << " frames=" << stream->frames
+                  << " scheduled=" << node.scheduler->getServed(stream->slot)
+                  << " dropped=" << queue.getDropped()
+                  << " reused=" << stream->reusedFrames
+                  << " queued=" << queue.size();
+        if (stream->writer)
         {
-            std::cout << "消费者退出 " << id << std::endl;
-            break;
+            std::cout << " encoded=" << stream->writer->getWritten()
+                      << " encode_dropped=" << stream->writer->getDropped();
         }
+        std::cout << std::endl;
+    }
+}
+
+/**
+ * @brief 流水线配置（各节点相同）
+ */
+struct PipelineConfig
+{
+    int consumers = 1;                                   ///< 推理线程数
+    int batchSize = 1;                                   ///< 推理批大小
+    int64_t batchWaitUs = 2000;                          ///< 凑批最大等待时间（微秒）
+    int cpuBatch = 1;                                    ///< CPU级每次取出的最大批量
+    int preprocessWorkers = 1;                           ///< 预处理级取批线程数
+    int postprocessWorkers = 1;                          ///< 后处理级取批线程数
+    int renderWorkers = 1;                               ///< 绘制级取批线程数
+    int limit = 5;                                       ///< 每级队列最大容量
+    bool track = false;                                  ///< 是否启用跟踪级
+    bool gate = false;                                   ///< 是否有视频流启用静止画面门控
+    bool render = false;                                 ///< 是否启用绘制级
+    string trackClass;                                   ///< 跟踪的类别（为空表示全部）
+};
+
+/**
+ * @brief 搭建节点的处理流水线
+ *
+ * CPU级的计算提交到本节点的线程池，推理使用本节点的模型；
+ * 推理级线程绑定到ORT的CPU，其余级的取批线程绑定到线程池的CPU
+ *
+ * @param node 执行节点（需已加载模型和创建线程池）
+ * @param config 流水线配置
+ */
+void build_pipeline(Node &node, const PipelineConfig &config)
+{
+    node.pipeline.reset(new Pipeline<Job>());
+    node.pipeline->setThreadInit([&node](const string &stage) {
+        // ORT计算线程占用 ort_cpus[1..]，推理线程作为调用线程绑定 ort_cpus[0]（未配置时为节点CPU）
+        if (stage == "infer")
+        {
+            pinCurrentThread(node.ortCpus.empty() ? node.cpus : vector<int>{node.ortCpus.front()});
+        }
+        else
+        {
+            pinCurrentThread(node.poolCpus);
+        }
+    });
+    node.pipeline->addStage("preprocess", config.preprocessWorkers, config.limit, [&node](vector<Job> &batch) {
+        node.taskPool->parallelFor(batch.size(), [&](size_t i) {
+            if (batch[i].reused)
+            {
+                return;
+            }
+            // 解码时已缩放的帧跳过缩放，检测框反变换回原始分辨率
+            batch[i].transformer = node.engine->preprocess(batch[i].inputImage.image(), streams[batch[i].stream]->sourceSize);
+        });
+    }, config.cpuBatch);
+    node.pipeline->addStage("infer", config.consumers, config.limit, [&node](vector<Job> &batch) {
+        // 复用结果的帧不参与推理
+        vector<cv::Mat> inputImages;
+        vector<size_t> inferred;
+        inputImages.reserve(batch.size());
+        for (size_t b = 0; b < batch.size(); b++)
+        {
+            if (!batch[b].reused)
+            {
+                inputImages.push_back(batch[b].transformer.getInputMat());
+                inferred.push_back(b);
+            }
+        }
+        if (inputImages.empty())
+        {
+            return;
+        }
+        auto begin = std::chrono::steady_clock::now();
+        vector<vector<cv::Mat>> outputs = node.engine->infer(inputImages);
+        if (node.batcher)
+        {
+            // 按实测单批耗时调整推理级的批量和凑批等待时间
+            node.batcher->recordBatch(inputImages.size(), std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count());
+        }
+        for (size_t k = 0; k < inferred.size(); k++)
+        {
+            batch[inferred[k]].outputs = std::move(outputs[k]);
+        }
+    }, config.batchSize, config.batchWaitUs);
+    node.pipeline->addStage("postprocess", config.postprocessWorkers, config.limit, [&node](vector<Job> &batch) {
+        node.taskPool->parallelFor(batch.size(), [&](size_t i) {
+            Job &job = batch[i];
+            if (job.reused)
+            {
+                return;
+            }
+            node.engine->postprocess(job.outputs, job.transformer, job.rects, job.names, job.confidences);
+            job.outputs.clear();
+            // 模型输入矩阵不再需要，及早释放，避免随作业在重排和编码队列中滞留
+            job.transformer = Transformer();
+        });
+    }, config.cpuBatch);
 
-        if (!jobs.empty())
-        {
-            // 预测
-            std::vector<std::vector<cv::Rect>> outputRects;
-            std::vector<std::vector<string>> outputNames;
-            std::vector<std::vector<float>> outputConfidences;
-            std::vector<std::vector<std::vector<cv::Point>>> points;
-            std::vector<std::vector<std::vector<float>>> pointConfidences;
-            vector<cv::Mat> images;
-            auto job = jobs.front();
-            jobs.pop();
-            cv::Mat image = job.inputImage;
-            images.push_back(image);
-            // 提前释放锁
-            lock.unlock();
-            detect.predict(images,
-                           outputRects,
-                           outputNames,
-                           outputConfidences,
-                           points,
-                           pointConfidences);
-
-            auto outputRect = outputRects.at(0);
-            auto outputConfidence = outputConfidences.at(0);
-
-            for (int i = 0; i < outputRect.size(); i++)
+    // 跟踪器和结果复用依赖帧序：乱序到达的帧先放入该路的重排缓冲，按帧序号依次复用上一推理帧的结果、更新该路的跟踪器
+    if (config.track || config.gate)
+    {
+        string trackClass = config.trackClass;
+        bool track = config.track;
+        node.pipeline->addStage(track ? "track" : "reuse", 1, config.limit, [&node, trackClass, track](vector<Job> &batch) {
+            vector<int> touched;
+            for (Job &job : batch)
+            {
+                int id = job.stream;
+                int64_t sequence = job.sequence;
+                streams[id]->trackOrder->insert(sequence, std::move(job));
+                touched.push_back(id);
+            }
+            batch.clear();
+            std::sort(touched.begin(), touched.end());
+            touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+            // 各路互不相关，按路并行（轨迹ID由 STrack::next_id 的原子计数器分配），每路内部仍按帧序串行
+            vector<vector<Job>> tracked(touched.size());
+            node.taskPool->parallelFor(touched.size(), [&](size_t t) {
+                Stream &stream = *streams[touched[t]];
+                Job job;
+                while (stream.trackOrder->tryPop(job))
+                {
+                    if (job.reused)
+                    {
+                        job.rects = stream.lastRects;
+                        job.names = stream.lastNames;
+                        job.confidences = stream.lastConfidences;
+                    }
+                    else if (stream.gateThreshold > 0)
+                    {
+                        stream.lastRects = job.rects;
+                        stream.lastNames = job.names;
+                        stream.lastConfidences = job.confidences;
+                    }
+                    if (!track)
+                    {
+                        tracked[t].push_back(std::move(job));
+                        continue;
+                    }
+                    std::vector<detect_result> detect_results;
+                    for (size_t i = 0; i < job.rects.size(); i++)
+                    {
+                        if (trackClass.empty() || job.names[i] == trackClass)
+                        {
+                            detect_result result;
+                            result.classId = 0;
+                            result.confidence = job.confidences[i];
+                            result.box = job.rects[i];
+                            detect_results.push_back(result);
+                        }
+                    }
+                    job.tracks = stream.tracker->update(detect_results);
+                    tracked[t].push_back(std::move(job));
+                }
+            });
+            for (vector<Job> &jobs : tracked)
             {
-                auto box = outputRect.at(i);
-                cv::rectangle(image, box, cv::Scalar(0, 0, 255), 2, 8);
-                putText(image, outputNames[0].at(i) + std::to_string(outputConfidences[0].at(i)), cv::Point(box.x + 10, box.y + 10), cv::FONT_HERSHEY_SIMPLEX, 1, cv::Scalar(0, 255, 0), 2);
+                for (Job &job : jobs)
+                {
+                    batch.push_back(std::move(job));
+                }
             }
-            // 将结果返回给生产者
-            job.outputImage->set_value(image);
-            // 通知生产者
-            condition_v.notify_all();
+        }, config.cpuBatch);
+    }
+    if (config.render)
+    {
+        bool tracks = config.track;
+        node.pipeline->addStage("render", config.renderWorkers, config.limit, [&node, tracks](vector<Job> &batch) {
+            node.taskPool->parallelFor(batch.size(), [&](size_t b) {
+                Job &job = batch[b];
+                draw_job(job, job.inputImage.image(), *streams[job.stream], tracks);
+            });
+        }, config.cpuBatch);
+    }
+    node.pipeline->addStage("sink", 1, config.limit, [](vector<Job> &batch) {
+        for (Job &job : batch)
+        {
+            // 按帧序号放入该路的重排缓冲，由该路的显示线程按序输出
+            int id = job.stream;
+            int64_t sequence = job.sequence;
+            streams[id]->results->insert(sequence, std::move(job));
+        }
+    }, config.batchSize);
+}
+
+/**
+ * @brief 打印各节点的流水线和线程池统计
+ */
+void report_nodes()
+{
+    for (const std::unique_ptr<Node> &node : nodes)
+    {
+        if (nodes.size() > 1)
+        {
+            std::cout << "node " << node->id << ":" << std::endl;
+        }
+        std::cout << node->pipeline->report() << node->taskPool->report();
+        if (node->batcher)
+        {
+            std::cout << node->batcher->report();
         }
     }
 }
 
 /**
  * @brief 打印使用说明
- * 
+ *
  * 显示程序的命令行参数使用方法和各参数的含义
  */
 void print_usage() {
-    cout << "Usage: ./luoyang_producer_consumer <model_dir> <consumer_num> <video_path> [output_path]" << endl;
+    cout << "Usage: ./luoyang_producer_consumer <model_dir> <consumer_num> <video_path[,video_path...]> [output_path]" << endl;
     cout << "Arguments:" << endl;
     cout << "  model_dir    : Path to YOLO model directory" << endl;
-    cout << "  consumer_num : Number of consumer threads" << endl;
-    cout << "  video_path   : Path to input video" << endl;
-    cout << "  output_path  : (Optional) Path to save output video" << endl;
+    cout << "  consumer_num : Number of inference threads (per numa node when numa=1)" << endl;
+    cout << "  video_path   : Path to input video, comma separated for multiple streams" << endl;
+    cout << "  output_path  : (Optional) Path to save output video, suffixed with _<stream> for multiple streams" << endl;
 }
 
 /**
  * @brief 主函数
- * 
- * 程序入口点，创建生产者和消费者线程，实现多线程视频处理
- * 
+ *
+ * 程序入口点，加载模型、搭建处理流水线并为每路视频流启动解码和显示线程，
+ * 实现单进程多路视频处理
+ *
  * @param argc 命令行参数数量
  * @param argv 命令行参数数组
  */
@@ -280,36 +881,419 @@ int main(int argc, char* argv[])
     // 解析命令行参数
     string model_dir = argv[1];
     int consumer_n = std::stoi(argv[2]);
-    string video_path = argv[3];
+    string video_paths = argv[3];
     string output_path = (argc > 4) ? argv[4] : "";
 
+    // 流水线参数，均可在 param.map 中配置
+    string paramPath = model_dir + "/param.map";
+    unordered_map<string, string> paramMap = readMap(paramPath);
+    int batch_size = std::max(1, std::stoi(paramMap["batch_size"]));
+    // 凑批最大等待时间（微秒）
+    int64_t batch_wait_us = paramMap.count("batch_wait_us") ? std::stoll(paramMap["batch_wait_us"]) : 2000;
+    // NUMA：numa=1 时每个节点（numa_nodes 指定，默认全部在线节点）一份模型和流水线，
+    // stream_nodes 按路指定所在节点（逗号分隔的节点编号），默认轮流分配
+    bool numa = param_int(paramMap, "numa", 0) != 0;
+    vector<int> numa_ids = numa ? (paramMap.count("numa_nodes") ? parseCpuList(paramMap["numa_nodes"]) : numaNodes()) : vector<int>{0};
+    // CPU级共享线程池的线程数（启用NUMA时为每个节点的线程数）和绑定的CPU（如 "0-7"），应与 ort_cpus 不重叠；
+    // decode_cpus 为解码线程绑定的CPU。启用NUMA时各节点取与本节点CPU的交集，未配置时绑定到本节点的全部CPU
+    int pool_workers = param_int(paramMap, "pool_workers", std::max(1, static_cast<int>(std::thread::hardware_concurrency() / std::max<size_t>(1, numa_ids.size()))));
+    vector<int> pool_cpus = parseCpuList(paramMap.count("pool_cpus") ? paramMap["pool_cpus"] : "");
+    vector<int> ort_cpus = parseCpuList(paramMap.count("ort_cpus") ? paramMap["ort_cpus"] : "");
+    vector<int> decode_cpus = parseCpuList(paramMap.count("decode_cpus") ? paramMap["decode_cpus"] : "");
+    // CPU级每次取出的最大批量，批内逐帧作为任务提交到线程池
+    int cpu_batch = std::max(1, param_int(paramMap, "cpu_batch", pool_workers));
+    // 各CPU级的取批线程数（实际计算在线程池中完成）
+    int preprocess_workers = param_int(paramMap, "preprocess_workers", 1);
+    int postprocess_workers = param_int(paramMap, "postprocess_workers", 1);
+    int render_workers = param_int(paramMap, "render_workers", 1);
+    // 每路结果重排窗口（最多同时在途的帧数），默认与每级队列容量相同，
+    // 窗口越大越能容忍单帧耗时的波动
+    int reorder_window = param_int(paramMap, "reorder_window", 0);
+    // 过载策略：block / drop_oldest / keep_latest / drop_nth，实时流建议使用丢帧策略以限制延迟
+    OverloadPolicy overload = parseOverloadPolicy(paramMap.count("overload") ? paramMap["overload"] : "block");
+    int drop_interval = param_int(paramMap, "drop_interval", 3);
+    // 多路调度方式：round_robin / deficit，deficit 时可用 stream_weights 按路设置权重（逗号分隔）
+    SchedulePolicy schedule_policy = parseSchedulePolicy(paramMap.count("schedule") ? paramMap["schedule"] : "round_robin");
+    // 无界面模式：不显示窗口，默认只在输出视频时绘制
+    headless = param_int(paramMap, "headless", 0) != 0;
+    // 逐帧结果输出：sink_path 为输出文件（sink_fifo=1 时为命名管道），sink_format 为 binary / jsonl
+    string sink_path = paramMap.count("sink_path") ? paramMap["sink_path"] : "";
+    SinkFormat sink_format = parseSinkFormat(paramMap.count("sink_format") ? paramMap["sink_format"] : "binary");
+    bool sink_fifo = param_int(paramMap, "sink_fifo", 0) != 0;
+    // 解码：decode_threads 为每路解码线程数（0自动），decode_skip 为 all / nonref / keyframes，
+    // decode_size 为letterbox目标尺寸（如 640x640，应与模型输入一致），设置后解码时直接缩放
+    VideoSource::Options decode_options;
+    decode_options.threads = param_int(paramMap, "decode_threads", 0);
+    decode_options.skip = parseDecodeSkip(paramMap.count("decode_skip") ? paramMap["decode_skip"] : "all");
+    decode_options.outputSize = parse_size(paramMap.count("decode_size") ? paramMap["decode_size"] : "");
+    // 可选级：跟踪（按帧序串行）与绘制
+    bool enable_track = param_int(paramMap, "track", 0) != 0;
+    // 绘制级只为窗口显示绘制；无界面时输出视频的框由编码线程叠加绘制
+    bool enable_render = param_int(paramMap, "render", headless ? 0 : 1) != 0;
+    string track_class = paramMap.count("track_class") ? paramMap["track_class"] : "";
+    int track_buffer = param_int(paramMap, "track_buffer", 30);
+    // 各级统计的打印间隔（秒），0表示只在退出时打印
+    int stats_interval = param_int(paramMap, "stats_interval", 0);
+    // 静止画面门控：gate_threshold 为亮度特征（gate_size，默认 64x36）与上一推理帧的平均绝对差阈值（0~255，0表示不门控），
+    // 低于阈值时复用上一推理帧的结果；gate_refresh 为连续复用的最大帧数。两者均可按路以逗号分隔配置
+    cv::Size gate_size = parse_size(paramMap.count("gate_size") ? paramMap["gate_size"] : "64x36");
+    // 输出视频：encode_queue 待编码队列容量，encode_drop=1 时队列满丢弃最旧的帧，
+    // encode_scale 小于1时以缩小的分辨率叠加绘制和编码，encode_threads 为编码器线程数（0为默认）
+    EncodeOptions encode_options;
+    encode_options.queue = std::max(1, param_int(paramMap, "encode_queue", 8));
+    encode_options.drop = param_int(paramMap, "encode_drop", 0) != 0;
+    encode_options.scale = paramMap.count("encode_scale") ? std::stod(paramMap["encode_scale"]) : 1.0;
+    if (!enable_render)
+    {
+        encode_options.overlay = [enable_track](Job &job, cv::Mat &image) {
+            draw_job(job, image, *streams[job.stream], enable_track);
+        };
+    }
+    int encode_threads = param_int(paramMap, "encode_threads", 0);
+    if (encode_threads > 0)
+    {
+        // OpenCV的FFmpeg写入后端从该环境变量读取编码器选项
+        setenv("OPENCV_FFMPEG_WRITER_OPTIONS", ("threads;" + std::to_string(encode_threads)).c_str(), 0);
+    }
 
-    // 队列最大容量    
-    int limit = 5 * consumer_n;
-    
-    std::vector<std::thread> consumers;
+    // 在途帧数需容纳流水线各级同时处理的帧（推理级为完整批次），否则永远凑不满批
+    int window = consumer_n * batch_size + (preprocess_workers + postprocess_workers + render_workers) * cpu_batch + 2;
+    // 每级队列最大容量
+    int limit = std::max(5 * consumer_n, window);
+    if (reorder_window <= 0)
+    {
+        reorder_window = limit;
+    }
+    // 每路接收队列容量
+    int ingest_capacity = param_int(paramMap, "ingest_capacity", limit);
+    // 延迟目标：slo_ms 大于0时按实测推理耗时和到达帧率在线调整推理批量（不超过 batch_size）和凑批等待时间，
+    // 使p95端到端延迟不超过 slo_ms；凑批等待时间在 [batch_min_wait_us, batch_max_wait_us] 内，每 batch_tune_ms 调整一次
+    double slo_ms = paramMap.count("slo_ms") ? std::stod(paramMap["slo_ms"]) : 0.0;
+    BatchController::Options batch_options;
+    batch_options.maxBatch = static_cast<size_t>(batch_size);
+    batch_options.workers = consumer_n;
+    batch_options.targetMs = slo_ms;
+    batch_options.minWaitUs = paramMap.count("batch_min_wait_us") ? std::stoll(paramMap["batch_min_wait_us"]) : 0;
+    batch_options.maxWaitUs = paramMap.count("batch_max_wait_us") ? std::stoll(paramMap["batch_max_wait_us"]) : std::max<int64_t>(batch_wait_us, 10000);
+    batch_options.intervalMs = param_int(paramMap, "batch_tune_ms", 500);
 
-    // 创建消费者线程
-    for (int i = 0; i < consumer_n; i++)
+    // 帧池需容纳：接收队列 + 重排窗口 + 待编码队列 + 正在解码、显示和编码的帧；
+    // 重排窗口不小于帧池，已编号的帧总能放入窗口，调度线程不会因某一路阻塞
+    int pool_size = ingest_capacity + reorder_window + 2 + (output_path.empty() ? 0 : static_cast<int>(encode_options.queue) + 1);
+    vector<string> paths = stringSplit(video_paths, ",");
+    for (size_t i = 0; i < paths.size(); i++)
     {
-        consumers.emplace_back(infer, i, model_dir);
+        std::unique_ptr<Stream> stream(new Stream());
+        stream->id = static_cast<int>(i);
+        stream->videoPath = paths[i];
+        streams.push_back(std::move(stream));
+    }
+    vector<double> gate_thresholds = param_per_stream(paramMap, "gate_threshold", streams.size(), 0.0);
+    vector<double> gate_refreshes = param_per_stream(paramMap, "gate_refresh", streams.size(), 25);
+    bool enable_gate = false;
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+        streams[i]->gateThreshold = gate_thresholds[i];
+        streams[i]->gateRefresh = static_cast<int>(gate_refreshes[i]);
+        streams[i]->gateSize = gate_size;
+        enable_gate = enable_gate || gate_thresholds[i] > 0;
     }
-    // 等所有消费者启动好 再开始启动生产者
-    std::this_thread::sleep_for(std::chrono::seconds(consumer_n == 1 ? 0 : consumer_n * load_delay));
 
-    // 创建生产者线程
-    std::thread capture_thread(capture, video_path, output_path, consumer_n, limit);
+    // 执行节点：各类线程的CPU取配置值（启用NUMA时与节点CPU求交集）
+    for (int id : numa_ids)
+    {
+        std::unique_ptr<Node> node(new Node());
+        node->id = id;
+        if (numa)
+        {
+            node->cpus = numaNodeCpus(id);
+            if (node->cpus.empty())
+            {
+                std::cerr << "Warning: numa node " << id << " has no cpu, skipped" << std::endl;
+                continue;
+            }
+        }
+        node->decodeCpus = node_cpus(decode_cpus, *node, "decode_cpus");
+        node->poolCpus = node_cpus(pool_cpus, *node, "pool_cpus");
+        // 未配置 ort_cpus 时不单独设置，ORT线程由绑定到节点CPU的加载线程创建，继承其绑定
+        node->ortCpus = ort_cpus.empty() ? vector<int>() : node_cpus(ort_cpus, *node, "ort_cpus");
+        nodes.push_back(std::move(node));
+    }
+    if (nodes.empty())
+    {
+        std::cerr << "Error: no usable numa node" << std::endl;
+        return -1;
+    }
+    // 分配视频流到节点，未分配视频流的节点不加载模型
+    vector<string> stream_nodes;
+    if (paramMap.count("stream_nodes"))
+    {
+        stream_nodes = stringSplit(paramMap["stream_nodes"], ",");
+    }
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+        size_t index = i % nodes.size();
+        if (i < stream_nodes.size())
+        {
+            int id = std::stoi(stream_nodes[i]);
+            auto it = std::find_if(nodes.begin(), nodes.end(), [id](const std::unique_ptr<Node> &node) { return node->id == id; });
+            if (it != nodes.end())
+            {
+                index = static_cast<size_t>(it - nodes.begin());
+            }
+            else
+            {
+                std::cerr << "Warning: stream " << i << " assigned to unknown numa node " << id << std::endl;
+            }
+        }
+        nodes[index]->streamIds.push_back(i);
+    }
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [](const std::unique_ptr<Node> &node) { return node->streamIds.empty(); }), nodes.end());
+    for (size_t n = 0; n < nodes.size(); n++)
+    {
+        for (size_t slot = 0; slot < nodes[n]->streamIds.size(); slot++)
+        {
+            Stream &stream = *streams[nodes[n]->streamIds[slot]];
+            stream.node = n;
+            stream.slot = slot;
+        }
+    }
+
+    // 每个节点只加载和预热一次模型（节点内的推理线程共享，ORT会话可并发推理），与打开视频流并行进行；
+    // 加载线程绑定到节点的CPU，模型权重和ORT线程由本节点的线程分配和创建
+    vector<std::future<void>> engine_futures;
+    for (const std::unique_ptr<Node> &node : nodes)
+    {
+        Node *target = node.get();
+        engine_futures.push_back(std::async(std::launch::async, [&model_dir, target]() {
+            pinCurrentThread(target->cpus);
+            auto begin = std::chrono::steady_clock::now();
+            target->engine.reset(new Detect(model_dir, target->ortCpus));
+            target->loadMs = elapsed_ms(begin);
+            begin = std::chrono::steady_clock::now();
+            target->engine->warmup();
+            target->warmupMs = elapsed_ms(begin);
+        }));
+    }
 
-    // 等待生产者线程结束
-    capture_thread.join();
+    // 各路视频流和执行节点创建后设置信号处理（加载期间也可中断）
+    struct sigaction sigIntHandler;
+    sigIntHandler.sa_handler = signal_handler;
+    sigemptyset(&sigIntHandler.sa_mask);
+    sigIntHandler.sa_flags = 0;
+    sigaction(SIGINT, &sigIntHandler, NULL);
+    sigaction(SIGTSTP, &sigIntHandler, NULL);
 
-    // 等待所有消费者线程结束
-    for (auto &consumer : consumers)
+    // 各路视频流并行打开（网络流的连接和探测可能耗时数秒）
+    vector<int64_t> open_ms(paths.size(), 0);
+    vector<char> opened(paths.size(), 0);
+    std::vector<std::thread> open_threads;
+    for (size_t i = 0; i < paths.size(); i++)
     {
-        // 等待消费者结束
-        consumer.join();
+        open_threads.emplace_back([&, i]() {
+            // FFmpeg解码线程继承打开线程的绑定，帧池由本节点的线程首次写入
+            pinCurrentThread(nodes[streams[i]->node]->decodeCpus);
+            auto begin = std::chrono::steady_clock::now();
+            opened[i] = open_stream(*streams[i], decode_options, output_path, encode_options, paths.size() > 1, pool_size, track_buffer);
+            open_ms[i] = elapsed_ms(begin);
+        });
+    }
+    for (auto &open_thread : open_threads)
+    {
+        open_thread.join();
+    }
+    int64_t streams_ready_ms = elapsed_ms();
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        if (!opened[i])
+        {
+            std::cerr << "Error: Could not open video from " << paths[i] << std::endl;
+            // 等待模型加载线程结束后再退出
+            for (auto &engine_future : engine_futures)
+            {
+                engine_future.wait();
+            }
+            return -1;
+        }
     }
 
+    for (const std::unique_ptr<Node> &node : nodes)
+    {
+        node->scheduler.reset(new FairScheduler<Job>(node->streamIds.size(), ingest_capacity, schedule_policy, overload, drop_interval));
+    }
+    if (paramMap.count("stream_weights"))
+    {
+        vector<string> weights = stringSplit(paramMap["stream_weights"], ",");
+        for (size_t i = 0; i < weights.size() && i < streams.size(); i++)
+        {
+            nodes[streams[i]->node]->scheduler->setWeight(streams[i]->slot, std::stod(weights[i]));
+        }
+    }
+
+    // 视频流就绪后立即开始解码，模型加载期间帧先进入各路接收队列（按过载策略积压或丢弃）
+    std::vector<std::thread> capture_threads;
+    for (const std::unique_ptr<Stream> &stream : streams)
+    {
+        capture_threads.emplace_back(capture, std::ref(*stream));
+    }
+
+    // 就绪屏障：各节点模型预热完成后才搭建流水线并开始调度
+    for (auto &engine_future : engine_futures)
+    {
+        engine_future.get();
+    }
+    int64_t engine_ready_ms = elapsed_ms();
+
+    if (!sink_path.empty())
+    {
+        // 命名管道在读端连接前阻塞，放在模型就绪后打开；读端退出时写入失败而不是收到SIGPIPE
+        if (sink_fifo)
+        {
+            signal(SIGPIPE, SIG_IGN);
+        }
+        resultSink.reset(new ResultSink(sink_path, sink_format, nodes.front()->engine->getClassNames(), sink_fifo));
+        if (!resultSink->isOpen())
+        {
+            resultSink.reset();
+        }
+    }
+
+    PipelineConfig pipeline_config;
+    pipeline_config.consumers = consumer_n;
+    pipeline_config.batchSize = batch_size;
+    pipeline_config.batchWaitUs = batch_wait_us;
+    pipeline_config.cpuBatch = cpu_batch;
+    pipeline_config.preprocessWorkers = preprocess_workers;
+    pipeline_config.postprocessWorkers = postprocess_workers;
+    pipeline_config.renderWorkers = render_workers;
+    pipeline_config.limit = limit;
+    pipeline_config.track = enable_track;
+    pipeline_config.gate = enable_gate;
+    pipeline_config.render = enable_render;
+    pipeline_config.trackClass = track_class;
+    for (const std::unique_ptr<Node> &node : nodes)
+    {
+        node->taskPool.reset(new TaskPool(pool_workers, node->poolCpus));
+        build_pipeline(*node, pipeline_config);
+        if (slo_ms > 0)
+        {
+            Pipeline<Job> *pipeline = node->pipeline.get();
+            node->batcher.reset(new BatchController(batch_options, batch_size, batch_wait_us, [pipeline](size_t batch, int64_t waitUs) {
+                pipeline->setBatching("infer", batch, waitUs);
+            }));
+        }
+        node->pipeline->start();
+        if (interrupted.load())
+        {
+            node->pipeline->abort();
+        }
+    }
+
+    // 启动耗时分解：模型加载和打开视频流并行，两者都完成后开始调度
+    std::cout << "启动耗时: 模型加载";
+    for (size_t n = 0; n < nodes.size(); n++)
+    {
+        std::cout << (n == 0 ? " " : "/") << nodes[n]->loadMs;
+    }
+    std::cout << " ms, 预热";
+    for (size_t n = 0; n < nodes.size(); n++)
+    {
+        std::cout << (n == 0 ? " " : "/") << nodes[n]->warmupMs;
+    }
+    std::cout << " ms, 打开视频流";
+    for (size_t i = 0; i < open_ms.size(); i++)
+    {
+        std::cout << (i == 0 ? " " : "/") << open_ms[i];
+    }
+    std::cout << " ms (全部就绪 " << streams_ready_ms << " ms), 推理就绪 " << engine_ready_ms
+              << " ms, 流水线就绪 " << elapsed_ms() << " ms" << std::endl;
+
+    // 每路一个显示线程（按帧序取结果、输出和编码），界面由单个界面线程负责，
+    // 每个节点一个调度线程负责把本节点各路的帧送入流水线
+    std::thread gui_thread;
+    if (!headless)
+    {
+        gui_frames.latest.resize(streams.size());
+        gui_frames.fresh.assign(streams.size(), false);
+        gui_thread = std::thread(gui_loop);
+    }
+    std::vector<std::thread> display_threads;
+    for (const std::unique_ptr<Stream> &stream : streams)
+    {
+        display_threads.emplace_back(display, std::ref(*stream));
+    }
+    std::atomic<size_t> schedule_running(nodes.size());
+    std::vector<std::thread> schedule_threads;
+    for (const std::unique_ptr<Node> &node : nodes)
+    {
+        Node *target = node.get();
+        schedule_threads.emplace_back([target, &schedule_running]() {
+            schedule(*target);
+            schedule_running.fetch_sub(1);
+        });
+    }
+
+    // 定期打印各级利用率和各路统计
+    while (stats_interval > 0 && schedule_running.load() > 0)
+    {
+        auto next_report = std::chrono::steady_clock::now() + std::chrono::seconds(stats_interval);
+        while (schedule_running.load() > 0 && std::chrono::steady_clock::now() < next_report)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        report_nodes();
+        report_streams();
+    }
+
+    // 等待解码线程和调度线程结束
+    for (auto &capture_thread : capture_threads)
+    {
+        capture_thread.join();
+    }
+    for (auto &schedule_thread : schedule_threads)
+    {
+        schedule_thread.join();
+    }
+    // 等待流水线各级退出，之后显示线程取完剩余结果
+    for (const std::unique_ptr<Node> &node : nodes)
+    {
+        node->pipeline->join();
+    }
+    for (const std::unique_ptr<Stream> &stream : streams)
+    {
+        stream->results->close();
+    }
+    for (auto &display_thread : display_threads)
+    {
+        display_thread.join();
+    }
+    if (gui_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(gui_frames.mutex);
+            gui_frames.closed = true;
+        }
+        gui_frames.ready.notify_one();
+        gui_thread.join();
+    }
+    // 释放
+    for (const std::unique_ptr<Stream> &stream : streams)
+    {
+        stream->source.release();
+        if (stream->writer)
+        {
+            // 写完待编码队列中的帧后关闭文件
+            stream->writer->close();
+        }
+    }
+    if (resultSink)
+    {
+        std::cout << "结果输出 " << sink_path << " " << resultSink->getWritten() << " 帧" << std::endl;
+        resultSink->close();
+    }
+    report_nodes();
+    report_streams();
+
     std::cout << "程序退出" << std::endl;
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,107 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "ObbDetect.h"
+
+using namespace std;
+using namespace cv;
+
+/**
+ * @brief 打印使用说明
+ * 
+ * 显示旋转目标检测程序的命令行参数使用方法和各参数的含义
+ */
+void print_usage() {
+    cout << "Usage: ./luoyang_yolo_obb <model_dir> <image_path> [output_path]" << endl;
+    cout << "Arguments:" << endl;
+    cout << "  model_dir    : Path to YOLO obb model directory" << endl;
+    cout << "  image_path   : Path to input image" << endl;
+    cout << "  output_path  : (Optional) Path to save output image" << endl;
+}
+
+/**
+ * @brief 执行旋转目标检测
+ * 
+ * 加载旋转目标检测模型，对指定图像进行检测，并显示或保存结果
+ * 
+ * @param model_dir 模型目录路径
+ * @param image_path 输入图像路径
+ * @param output_path 输出图像路径（可选）
+ */
+void object_obb_detection(const string& model_dir, const string& image_path, const string& output_path = "") {
+    try {
+        // 创建旋转目标检测器
+        ObbDetect detect(model_dir);
+        cv::Mat image = cv::imread(image_path);
+
+        // 检查图像是否成功加载
+        if (image.empty()) {
+            cerr << "Error: Could not read image from " << image_path << endl;
+            return;
+        }
+
+        // 准备输出容器
+        std::vector<std::vector<cv::RotatedRect>> outputBoxes;
+        std::vector<std::vector<string>> outputNames;
+        std::vector<std::vector<float>> outputConfidences;
+        vector<cv::Mat> images;
+        images.push_back(image);
+
+        // 执行旋转目标检测
+        detect.predict(images,
+                       outputBoxes,
+                       outputNames,
+                       outputConfidences);
+
+        // 在图像上绘制旋转框
+        for (int i = 0; i < outputBoxes[0].size(); i++) {
+            cv::Point2f vertices[4];
+            outputBoxes[0][i].points(vertices);
+            std::vector<std::vector<cv::Point>> polygon(1);
+            for (cv::Point2f vertex : vertices) {
+                polygon[0].push_back(vertex);
+            }
+            cv::polylines(image, polygon, true, cv::Scalar(0, 0, 255), 2);
+            putText(image, outputNames[0].at(i), polygon[0][0],
+                    cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 255, 0));
+        }
+
+        // 保存或显示结果
+        if (!output_path.empty()) {
+            cv::imwrite(output_path, image);
+            cout << "Result saved to: " << output_path << endl;
+        } else {
+            cv::imshow("obb", image);
+            cv::waitKeyEx();
+        }
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+    }
+}
+
+/**
+ * @brief 主函数
+ * 
+ * 程序入口点，解析命令行参数并调用旋转目标检测函数
+ * 
+ * @param argc 命令行参数数量
+ * @param argv 命令行参数数组
+ * @return int 程序退出码
+ */
+int main(int argc, char* argv[]) {
+    // 检查参数数量
+    if (argc < 3) {
+        print_usage();
+        return -1;
+    }
+
+    // 解析命令行参数
+    string model_dir = argv[1];
+    string image_path = argv[2];
+    string output_path = (argc > 3) ? argv[3] : "";
+
+    // 执行旋转目标检测
+    object_obb_detection(model_dir, image_path, output_path);
+    return 0;
+}
@@ -1,9 +1,18 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <thread>
+#include <memory>
+#include <csignal>
 #include <opencv2/opencv.hpp>
 #include "Detect.h"
 #include "BYTETracker.h"
+#include "VideoSource.h"
+#include "AsyncWriter.h"
+#include "ResultSink.h"
+#include "MosaicPacker.h"
+#include "TrackletStitcher.h"
+#include "MotionRegions.h"
 
 using namespace std;
 using namespace cv;
@@ -20,6 +29,66 @@ void print_usage() {
     cout << "  video_path        : Path to input video" << endl;
     cout << "  output_video_path : (Optional) Path to save output video" << endl;
     cout << "  target_class      : (Optional) Target class to track (default: person)" << endl;
+    cout << "With segments=N (N > 1) in param.map the video is tracked offline in N parallel segments;" << endl;
+    cout << "an output path ending in .txt receives MOT-format track records instead of a video." << endl;
+}
+
+/**
+ * @brief 生成轨迹引导的裁剪区域
+ * 
+ * 每个预测框按边距外扩（不小于最小边长）并裁剪到图像范围内，重叠较多的区域合并，
+ * 合并后的面积不超过两者面积之和时才合并，避免合并出大片空白
+ * 
+ * @param boxes 预测的轨迹框
+ * @param frameSize 图像尺寸
+ * @param margin 每侧外扩的比例（相对于框的宽高）
+ * @param minSize 裁剪区域的最小边长
+ * @return vector<cv::Rect> 裁剪区域
+ */
+vector<cv::Rect> track_crops(const vector<cv::Rect_<float>> &boxes, const cv::Size &frameSize, float margin, int minSize) {
+    cv::Rect frameRect(0, 0, frameSize.width, frameSize.height);
+    vector<cv::Rect> crops;
+    for (const cv::Rect_<float> &box : boxes) {
+        float w = std::max(box.width * (1 + 2 * margin), static_cast<float>(minSize));
+        float h = std::max(box.height * (1 + 2 * margin), static_cast<float>(minSize));
+        float cx = box.x + box.width / 2;
+        float cy = box.y + box.height / 2;
+        cv::Rect crop = cv::Rect(static_cast<int>(cx - w / 2), static_cast<int>(cy - h / 2), static_cast<int>(w), static_cast<int>(h)) & frameRect;
+        if (crop.area() > 0) {
+            crops.push_back(crop);
+        }
+    }
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < crops.size() && !merged; i++) {
+            for (size_t j = i + 1; j < crops.size() && !merged; j++) {
+                cv::Rect joined = crops[i] | crops[j];
+                if ((crops[i] & crops[j]).area() > 0 && joined.area() <= crops[i].area() + crops[j].area()) {
+                    crops[i] = joined;
+                    crops.erase(crops.begin() + j);
+                    merged = true;
+                }
+            }
+        }
+    }
+    return crops;
+}
+
+/**
+ * @brief 检测框是否贴在裁剪区域的内部边界上（目标被裁剪截断）
+ * 
+ * @param box 裁剪区域坐标系下的检测框
+ * @param crop 裁剪区域
+ * @param frameSize 图像尺寸
+ * @return bool 与图像内部的某条裁剪边距离不超过2像素时返回true
+ */
+bool touches_crop_edge(const cv::Rect &box, const cv::Rect &crop, const cv::Size &frameSize) {
+    const int tolerance = 2;
+    return (crop.x > 0 && box.x <= tolerance) ||
+           (crop.y > 0 && box.y <= tolerance) ||
+           (crop.x + crop.width < frameSize.width && box.x + box.width >= crop.width - tolerance) ||
+           (crop.y + crop.height < frameSize.height && box.y + box.height >= crop.height - tolerance);
 }
 
 /**
@@ -37,25 +106,25 @@ void object_tracking(const string& model_dir, const string& video_path, const st
         // 创建检测器实例
         Detect detect(model_dir);
         
-        // 打开视频文件
-        cv::VideoCapture cap(video_path);
-        if (!cap.isOpened()) {
+        // 打开视频文件（FFmpeg多线程解码）
+        VideoSource cap;
+        if (!cap.open(video_path, VideoSource::Options())) {
             cerr << "Error: Could not open video from " << video_path << endl;
             return;
         }
         
         // 获取视频属性
-        int frame_width = static_cast<int>(cap.get(CAP_PROP_FRAME_WIDTH));
-        int frame_height = static_cast<int>(cap.get(CAP_PROP_FRAME_HEIGHT));
-        double fps = cap.get(CAP_PROP_FPS);
+        int frame_width = cap.getSourceSize().width;
+        int frame_height = cap.getSourceSize().height;
+        double fps = cap.getFps();
         
-        // 初始化视频写入器（如果指定了输出路径）
-        cv::VideoWriter writer;
+        // 初始化视频写入器（如果指定了输出路径），编码在独立线程中进行，不阻塞检测
+        AsyncWriter<cv::Mat> writer(8);
         bool save_video = !output_path.empty();
         if (save_video) {
-            writer = cv::VideoWriter(output_path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps, 
-                                   cv::Size(frame_width, frame_height));
-            if (!writer.isOpened()) {
+            if (!writer.open(output_path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps,
+                             cv::Size(frame_width, frame_height), 1.0,
+                             [](cv::Mat &image) -> cv::Mat & { return image; })) {
                 cerr << "Error: Could not create video writer for " << output_path << endl;
                 return;
             }
@@ -63,6 +132,65 @@ void object_tracking(const string& model_dir, const string& video_path, const st
 
         // 初始化跟踪器
         BYTETracker tracker(fps, 30);
+
+        // 跳帧检测：detect_stride 为检测间隔（1为逐帧检测），中间帧只用卡尔曼滤波预测轨迹位置；
+        // adaptive_stride=1 时出现新目标、丢失目标或轨迹位置不确定度超过 stride_uncertainty（中心点标准差/框高）时缩短间隔
+        string paramPath = model_dir + "/param.map";
+        unordered_map<string, string> paramMap = readMap(paramPath);
+        // 无界面模式：headless=1 时不创建窗口，未指定输出路径时也不绘制
+        bool headless = paramMap.count("headless") && stoi(paramMap["headless"]) != 0;
+        // 逐帧结果输出：sink_path 为输出文件（sink_fifo=1 时为命名管道），sink_format 为 binary / jsonl，写入每帧的跟踪结果
+        std::unique_ptr<ResultSink> sink;
+        if (paramMap.count("sink_path") && !paramMap["sink_path"].empty()) {
+            bool sink_fifo = paramMap.count("sink_fifo") && stoi(paramMap["sink_fifo"]) != 0;
+            if (sink_fifo) {
+                // 读端退出时写入失败而不是收到SIGPIPE
+                signal(SIGPIPE, SIG_IGN);
+            }
+            sink.reset(new ResultSink(paramMap["sink_path"],
+                                      parseSinkFormat(paramMap.count("sink_format") ? paramMap["sink_format"] : "binary"),
+                                      detect.getClassNames(), sink_fifo));
+            if (!sink->isOpen()) {
+                cerr << "Error: Could not open result sink " << paramMap["sink_path"] << endl;
+                sink.reset();
+            }
+        }
+        int detect_stride = paramMap.count("detect_stride") ? std::max(1, stoi(paramMap["detect_stride"])) : 1;
+        bool adaptive_stride = paramMap.count("adaptive_stride") && stoi(paramMap["adaptive_stride"]) != 0;
+        float stride_uncertainty = paramMap.count("stride_uncertainty") ? stof(paramMap["stride_uncertainty"]) : 0.2f;
+        // 裁剪推理：crop_mode=1 时两次整帧检测（间隔 crop_interval 帧）之间只在预测轨迹框周围
+        // （每侧外扩 crop_margin，最小边长 crop_min_size）的裁剪区域上检测，裁剪区域合并为一批推理；
+        // 区域数超过 crop_max（默认为模型批大小）或总面积超过画面的 crop_max_area 时改为整帧检测
+        bool crop_mode = paramMap.count("crop_mode") && stoi(paramMap["crop_mode"]) != 0;
+        int crop_interval = paramMap.count("crop_interval") ? std::max(1, stoi(paramMap["crop_interval"])) : 10;
+        float crop_margin = paramMap.count("crop_margin") ? stof(paramMap["crop_margin"]) : 0.5f;
+        int crop_min_size = paramMap.count("crop_min_size") ? stoi(paramMap["crop_min_size"]) : 64;
+        size_t crop_max = paramMap.count("crop_max") ? stoul(paramMap["crop_max"]) : static_cast<size_t>(std::max(1, detect.getBatchSize()));
+        float crop_max_area = paramMap.count("crop_max_area") ? stof(paramMap["crop_max_area"]) : 0.5f;
+        // 拼图推理：crop_pack=1 时裁剪区域按原始分辨率拼入模型输入尺寸的画布（间隔 crop_pack_gap 像素），
+        // 每张画布推理一次，此时 crop_max 限制的是画布数
+        bool crop_pack = paramMap.count("crop_pack") && stoi(paramMap["crop_pack"]) != 0;
+        int crop_pack_gap = paramMap.count("crop_pack_gap") ? stoi(paramMap["crop_pack_gap"]) : 4;
+        MosaicPacker packer(detect.getInputSize(), crop_pack_gap);
+        // 变化区域推理：motion_mode=1 时维护低分辨率背景模型（宽 motion_width，更新速率 motion_rate，灰度阈值 motion_threshold），
+        // 检测只在画面变化区域（最多 motion_max_regions 个，可与裁剪区域一起拼图）上进行，未变化区域中的轨迹沿用当前位置；
+        // 每 motion_full_interval 帧整帧检测一次，0表示不做周期性整帧检测（与 crop_mode 同时开启时按两者中先到的间隔）
+        bool motion_mode = paramMap.count("motion_mode") && stoi(paramMap["motion_mode"]) != 0;
+        int motion_full_interval = paramMap.count("motion_full_interval") ? std::max(0, stoi(paramMap["motion_full_interval"])) : 30;
+        MotionRegions::Options motionOptions;
+        motionOptions.width = paramMap.count("motion_width") ? stoi(paramMap["motion_width"]) : motionOptions.width;
+        motionOptions.learningRate = paramMap.count("motion_rate") ? stod(paramMap["motion_rate"]) : motionOptions.learningRate;
+        motionOptions.threshold = paramMap.count("motion_threshold") ? stod(paramMap["motion_threshold"]) : motionOptions.threshold;
+        motionOptions.maxRegions = paramMap.count("motion_max_regions") ? stoul(paramMap["motion_max_regions"]) : motionOptions.maxRegions;
+        motionOptions.minSize = crop_min_size;
+        MotionRegions motion(motionOptions);
+        int unchanged_frames = 0;
+        int since_full = crop_interval;
+        int full_frames = 0;
+        int stride = detect_stride;
+        int since_detect = 0;
+        int detected_frames = 0;
+        double last_timestamp = -1;
         
         cv::Mat frame;
         int frame_id = 0;
@@ -71,74 +199,227 @@ void object_tracking(const string& model_dir, const string& video_path, const st
         
         // 逐帧处理视频
         while (true) {
-            cap >> frame;
-            if (frame.empty()) {
+            if (!cap.read(frame)) {
                 break;
             }
             
             frame_id++;
-            
-            // 进行目标检测
-            // 定义检测结果容器
-            std::vector<std::vector<cv::Rect>> outputRects;        // 存储检测到的目标边界框
-            std::vector<std::vector<string>> outputNames;         // 存储检测到的目标类别名称
-            std::vector<std::vector<float>> outputConfidences;    // 存储检测置信度
-            std::vector<std::vector<std::vector<cv::Point>>> points;        // 存储关键点坐标
-            std::vector<std::vector<std::vector<float>>> pointConfidences;  // 存储关键点置信度
-            
-            // 准备输入图像
-            vector<cv::Mat> images;
-            images.push_back(frame);
-            
-            // 执行检测
-            detect.predict(images,
-                          outputRects,
-                          outputNames,
-                          outputConfidences,
-                          points,
-                          pointConfidences);
-         
-            // 将检测结果转换为跟踪器所需的格式
-            std::vector<detect_result> detect_results;
-            for (int i = 0; i < outputRects[0].size(); i++) {
-                // 只跟踪指定类别的目标
-                if(outputNames[0][i] == target_class){
-                    detect_result result;
-                    result.classId = 0; 
-                    result.confidence = outputConfidences[0][i];
-                    result.box = outputRects[0][i];
-                    detect_results.push_back(result);
+            since_full++;
+
+            // 按帧时间戳计算距上一帧的间隔（以帧为单位），跳帧或帧间隔不均匀时预测仍按实际时间推进
+            double timestamp = cap.getTimestamp();
+            float dt = 1.f;
+            if (last_timestamp >= 0 && fps > 0 && timestamp > last_timestamp) {
+                dt = static_cast<float>((timestamp - last_timestamp) * fps);
+            }
+            last_timestamp = timestamp;
+
+            // 背景模型逐帧更新，变化区域在检测帧上使用
+            vector<cv::Rect> motion_regions;
+            if (motion_mode) {
+                motion_regions = motion.update(frame);
+            }
+
+            // 中间帧：轨迹不确定度过高时提前检测，否则只做预测
+            bool run_detect = frame_id == 1 || since_detect >= stride ||
+                              (adaptive_stride && tracker.max_uncertainty() > stride_uncertainty);
+            std::vector<STrack> tracking_results;
+            if (!run_detect) {
+                tracking_results = tracker.predict(dt);
+                since_detect++;
+            } else {
+                // 进行目标检测
+                // 定义检测结果容器
+                std::vector<std::vector<cv::Rect>> outputRects;        // 存储检测到的目标边界框
+                std::vector<std::vector<string>> outputNames;         // 存储检测到的目标类别名称
+                std::vector<std::vector<float>> outputConfidences;    // 存储检测置信度
+                std::vector<std::vector<std::vector<cv::Point>>> points;        // 存储关键点坐标
+                std::vector<std::vector<std::vector<float>>> pointConfidences;  // 存储关键点置信度
+
+                // 准备输入图像：整帧，或局部区域（ROI视图，不复制像素）：预测轨迹框周围的裁剪区域、画面变化区域
+                vector<cv::Rect> crops;
+                vector<MosaicPacker::Tile> tiles;
+                vector<MosaicPacker::Canvas> canvases;
+                std::vector<detect_result> carried;
+                bool full_frame = frame_id == 1 || (!crop_mode && !motion_mode) ||
+                                  (crop_mode && since_full >= crop_interval) ||
+                                  (motion_mode && motion_full_interval > 0 && since_full >= motion_full_interval);
+                if (!full_frame) {
+                    vector<cv::Rect_<float>> predicted = tracker.predict_boxes(dt);
+                    if (crop_mode) {
+                        crops = track_crops(predicted, frame.size(), crop_margin, crop_min_size);
+                    }
+                    if (motion_mode) {
+                        // 变化区域扩展到完整覆盖与其相交的预测轨迹框；只有变化区域时，其余轨迹所在画面未变化，
+                        // 以当前位置作为检测结果沿用（裁剪区域已覆盖全部轨迹时不需要）
+                        vector<cv::Rect_<float>> current = tracker.predict_boxes(0.f);
+                        cv::Rect frameRect(0, 0, frame.cols, frame.rows);
+                        for (size_t t = 0; t < predicted.size(); t++) {
+                            cv::Rect box = cv::Rect(predicted[t]) & frameRect;
+                            bool changed = false;
+                            for (cv::Rect &region : motion_regions) {
+                                if ((region & box).area() > 0) {
+                                    region |= box;
+                                    changed = true;
+                                }
+                            }
+                            if (!changed && !crop_mode) {
+                                detect_result result;
+                                result.classId = 0;
+                                result.confidence = 1.f;
+                                result.box = current[t];
+                                carried.push_back(result);
+                            }
+                        }
+                        crops.insert(crops.end(), motion_regions.begin(), motion_regions.end());
+                        MotionRegions::merge(crops, 0, 0);
+                    }
+                    int crop_area = 0;
+                    for (const cv::Rect &crop : crops) {
+                        crop_area += crop.area();
+                    }
+                    if (crop_pack && !crops.empty()) {
+                        for (const cv::Rect &crop : crops) {
+                            MosaicPacker::Tile tile;
+                            tile.image = frame;
+                            tile.roi = crop;
+                            tiles.push_back(tile);
+                        }
+                        canvases = packer.pack(tiles);
+                    }
+                    // 区域（画布）过多或过大时整帧检测更划算；只有裁剪区域时没有轨迹也整帧检测，
+                    // 有变化区域时没有区域说明画面未变化，不做推理
+                    size_t crop_count = crop_pack ? canvases.size() : crops.size();
+                    if (crop_count > crop_max || crop_area > crop_max_area * frame.cols * frame.rows ||
+                        (crops.empty() && !motion_mode)) {
+                        full_frame = true;
+                        carried.clear();
+                    }
+                }
+                vector<cv::Mat> images;
+                if (full_frame) {
+                    crops.clear();
+                    images.push_back(frame);
+                    since_full = 0;
+                    full_frames++;
+                } else if (crop_pack) {
+                    for (const MosaicPacker::Canvas &canvas : canvases) {
+                        images.push_back(canvas.image);
+                    }
+                } else {
+                    for (const cv::Rect &crop : crops) {
+                        images.push_back(frame(crop));
+                    }
+                }
+
+                // 执行检测
+                if (images.empty()) {
+                    unchanged_frames++;
+                } else {
+                    detect.predict(images,
+                                  outputRects,
+                                  outputNames,
+                                  outputConfidences,
+                                  points,
+                                  pointConfidences);
+                }
+
+                // 将检测结果转换为跟踪器所需的格式
+                std::vector<detect_result> detect_results = carried;
+                std::vector<cv::Rect> crop_boxes;
+                std::vector<float> crop_scores;
+                for (size_t k = 0; k < outputRects.size(); k++) {
+                    if (!full_frame && crop_pack) {
+                        // 按检测框所在区域拆分回整帧坐标，跨区域或被裁剪边界截断的框由拆分过滤
+                        vector<MosaicPacker::Detection> detections;
+                        packer.unpack(canvases[k], tiles, outputRects[k], outputNames[k], outputConfidences[k], detections);
+                        for (const MosaicPacker::Detection &detection : detections) {
+                            if (detection.name == target_class) {
+                                crop_boxes.push_back(detection.box);
+                                crop_scores.push_back(detection.confidence);
+                            }
+                        }
+                        continue;
+                    }
+                    for (int i = 0; i < outputRects[k].size(); i++) {
+                        // 只跟踪指定类别的目标
+                        if (outputNames[k][i] != target_class) {
+                            continue;
+                        }
+                        if (full_frame) {
+                            detect_result result;
+                            result.classId = 0; 
+                            result.confidence = outputConfidences[k][i];
+                            result.box = outputRects[k][i];
+                            detect_results.push_back(result);
+                        } else if (!touches_crop_edge(outputRects[k][i], crops[k], frame.size())) {
+                            // 映射回整帧坐标，被裁剪边界截断的框丢弃
+                            crop_boxes.push_back(outputRects[k][i] + crops[k].tl());
+                            crop_scores.push_back(outputConfidences[k][i]);
+                        }
+                    }
+                }
+                if (!full_frame) {
+                    // 相邻裁剪区域的重叠部分可能重复检出同一目标
+                    std::vector<int> keep;
+                    cv::dnn::NMSBoxes(crop_boxes, crop_scores, 0.f, 0.5f, keep);
+                    for (int index : keep) {
+                        detect_result result;
+                        result.classId = 0;
+                        result.confidence = crop_scores[index];
+                        result.box = crop_boxes[index];
+                        detect_results.push_back(result);
+                    }
+                }
+
+                // 使用BYTETracker更新跟踪状态
+                int lost_before = tracker.lost_count();
+                tracking_results = tracker.update(detect_results, dt);
+                since_detect = 1;
+                detected_frames++;
+                if (adaptive_stride) {
+                    // 新目标待确认（需在下一次检测中再次匹配）、有目标丢失或位置不确定时减半，否则逐步恢复
+                    bool unstable = tracker.unconfirmed_count() > 0 || tracker.lost_count() > lost_before ||
+                                    tracker.max_uncertainty() > stride_uncertainty;
+                    stride = unstable ? std::max(1, stride / 2) : std::min(detect_stride, stride + 1);
                 }
             }
-      
-            // 使用BYTETracker更新跟踪状态
-            std::vector<STrack> tracking_results = tracker.update(detect_results);
             
-            // 在图像上绘制检测框和跟踪ID
-            for (int i = 0; i < tracking_results.size(); i++) {
-                STrack track = tracking_results[i];
+            // 输出本帧的跟踪结果；读端关闭等写入失败时提示一次并停止输出
+            if (sink && !sink->write(0, frame_id - 1, {}, {}, {}, tracking_results)) {
+                cerr << "Error: Result sink write failed after " << sink->getWritten() << " frames, stop writing" << endl;
+                sink.reset();
+            }
+
+            // 在图像上绘制检测框和跟踪ID（无界面且不保存视频时跳过）
+            if (save_video || !headless) {
+                for (int i = 0; i < tracking_results.size(); i++) {
+                    STrack track = tracking_results[i];
                 
-                // 获取跟踪框并转换为绘制格式
-                track.static_tlbr(); // 确保tlbr坐标已计算
-                cv::Rect box = cv::Rect(track.tlbr[0], track.tlbr[1], track.tlbr[2] - track.tlbr[0], track.tlbr[3] - track.tlbr[1]);
+                    // 获取跟踪框并转换为绘制格式
+                    track.static_tlbr(); // 确保tlbr坐标已计算
+                    cv::Rect box = cv::Rect(track.tlbr[0], track.tlbr[1], track.tlbr[2] - track.tlbr[0], track.tlbr[3] - track.tlbr[1]);
                 
-                // 绘制边界框
-                // 使用track_id对应的颜色，提高多目标的可视化区分度
-                cv::rectangle(frame, box, tracker.get_color(track.track_id), 2, 8);
+                    // 绘制边界框
+                    // 使用track_id对应的颜色，提高多目标的可视化区分度
+                    cv::rectangle(frame, box, tracker.get_color(track.track_id), 2, 8);
                 
-                // 绘制跟踪ID
-                char track_id_str[10];
-                sprintf(track_id_str, "%d", track.track_id);
+                    // 绘制跟踪ID
+                    char track_id_str[10];
+                    sprintf(track_id_str, "%d", track.track_id);
                 
-                // 在边界框顶部显示跟踪ID
-                cv::putText(frame, track_id_str, cv::Point(box.x, box.y - 10), 
-                           cv::FONT_HERSHEY_SIMPLEX, 0.5, tracker.get_color(track.track_id), 2);
+                    // 在边界框顶部显示跟踪ID
+                    cv::putText(frame, track_id_str, cv::Point(box.x, box.y - 10), 
+                               cv::FONT_HERSHEY_SIMPLEX, 0.5, tracker.get_color(track.track_id), 2);
+                }
             }
             
             // 保存或显示结果帧
             if (save_video) {
+                // 帧交给编码线程，下一帧解码到新的缓冲
                 writer.write(frame);
-            } else {
+                frame = cv::Mat();
+            } else if (!headless) {
                 cv::imshow("Object Tracking", frame);
                 if (cv::waitKey(1) == 27) { // ESC键退出
                     break;
@@ -154,18 +435,259 @@ void object_tracking(const string& model_dir, const string& video_path, const st
         // 释放资源
         cap.release();
         if (save_video) {
-            writer.release();
+            writer.close();
             cout << "Result saved to: " << output_path << endl;
         }
-        cv::destroyAllWindows();
+        if (!headless) {
+            cv::destroyAllWindows();
+        }
+        if (sink) {
+            cout << "Tracks written to " << paramMap["sink_path"] << ": " << sink->getWritten() << " frames" << endl;
+            sink->close();
+        }
         
-        cout << "Tracking completed. Total frames processed: " << frame_id << endl;
+        cout << "Tracking completed. Total frames processed: " << frame_id
+             << ", detected: " << detected_frames << " (full frame: " << full_frames
+             << ", unchanged: " << unchanged_frames << ")" << endl;
         
     } catch (const exception& e) {
         cerr << "Error: " << e.what() << endl;
     }
 }
 
+/**
+ * @brief 按时间戳换算帧序号，各分段独立解码时得到一致的序号
+ * 
+ * @param timestamp 时间戳（秒）
+ * @param fps 帧率
+ * @return int64_t 帧序号
+ */
+int64_t frame_index(double timestamp, double fps) {
+    return static_cast<int64_t>(std::llround(timestamp * (fps > 0 ? fps : 25.0)));
+}
+
+/**
+ * @brief 逐帧检测并跟踪视频的一个分段
+ * 
+ * 定位到分段起始关键帧后解码，跳过关键帧之前的帧，到达结束时间时停止
+ * 
+ * @param detect 检测器（各分段共用，推理可并发）
+ * @param video_path 视频路径
+ * @param begin 起始时间（秒，关键帧时间戳）
+ * @param end 结束时间（秒，不含）
+ * @param target_class 目标跟踪类别
+ * @param threads 解码线程数
+ * @return vector<TrackRecord> 分段内的跟踪结果（分段内轨迹ID）
+ */
+vector<TrackRecord> track_segment(Detect &detect, const string &video_path, double begin, double end,
+                                  const string &target_class, int threads) {
+    VideoSource cap;
+    VideoSource::Options options;
+    options.threads = threads;
+    if (!cap.open(video_path, options) || (begin > 0 && !cap.seek(begin))) {
+        throw runtime_error("could not open video segment from " + video_path);
+    }
+    double fps = cap.getFps();
+    const double epsilon = fps > 0 ? 0.5 / fps : 1e-3;
+    BYTETracker tracker(fps, 30);
+    vector<TrackRecord> records;
+    double last_timestamp = -1;
+    cv::Mat frame;
+    while (cap.read(frame)) {
+        double timestamp = cap.getTimestamp();
+        if (timestamp < begin - epsilon) {
+            continue;
+        }
+        if (timestamp >= end - epsilon) {
+            break;
+        }
+        float dt = 1.f;
+        if (last_timestamp >= 0 && fps > 0 && timestamp > last_timestamp) {
+            dt = static_cast<float>((timestamp - last_timestamp) * fps);
+        }
+        last_timestamp = timestamp;
+
+        std::vector<std::vector<cv::Rect>> outputRects;
+        std::vector<std::vector<string>> outputNames;
+        std::vector<std::vector<float>> outputConfidences;
+        std::vector<std::vector<std::vector<cv::Point>>> points;
+        std::vector<std::vector<std::vector<float>>> pointConfidences;
+        detect.predict(vector<cv::Mat>{frame}, outputRects, outputNames, outputConfidences, points, pointConfidences);
+
+        std::vector<detect_result> detect_results;
+        for (size_t i = 0; i < outputRects[0].size(); i++) {
+            if (outputNames[0][i] == target_class) {
+                detect_result result;
+                result.classId = 0;
+                result.confidence = outputConfidences[0][i];
+                result.box = outputRects[0][i];
+                detect_results.push_back(result);
+            }
+        }
+        int64_t index = frame_index(timestamp, fps);
+        for (STrack &track : tracker.update(detect_results, dt)) {
+            TrackRecord record;
+            record.frame = index;
+            record.id = track.track_id;
+            record.box = cv::Rect_<float>(track.tlwh[0], track.tlwh[1], track.tlwh[2], track.tlwh[3]);
+            record.score = track.score;
+            records.push_back(record);
+        }
+    }
+    return records;
+}
+
+/**
+ * @brief 离线分段并行跟踪
+ * 
+ * 按关键帧将视频切成 segments 个分段，相邻分段重叠 segment_overlap 秒，每个分段由独立线程解码、检测和跟踪；
+ * 重叠窗口内的轨迹按IoU和时间连续性拼接为全局ID（stitch_iou、stitch_min_frames、stitch_max_gap）。
+ * 输出路径以 .txt 结尾时写入MOT格式的跟踪记录，否则顺序解码一遍绘制全局ID后写入视频。
+ * 
+ * @param model_dir 模型目录路径
+ * @param video_path 输入视频路径（文件）
+ * @param output_path 输出路径（可选）
+ * @param target_class 目标跟踪类别
+ * @param paramMap 参数
+ */
+void segment_tracking(const string& model_dir, const string& video_path, const string& output_path,
+                      const string& target_class, unordered_map<string, string> &paramMap) {
+    try {
+        int segments = std::max(1, stoi(paramMap["segments"]));
+        double overlap = paramMap.count("segment_overlap") ? stod(paramMap["segment_overlap"]) : 2.0;
+        TrackletStitcher::Options stitchOptions;
+        if (paramMap.count("stitch_iou")) {
+            stitchOptions.iou = stof(paramMap["stitch_iou"]);
+        }
+        if (paramMap.count("stitch_min_frames")) {
+            stitchOptions.minFrames = stoi(paramMap["stitch_min_frames"]);
+        }
+        if (paramMap.count("stitch_max_gap")) {
+            stitchOptions.maxGap = stoi(paramMap["stitch_max_gap"]);
+        }
+
+        // 只解复用扫描关键帧，分段起点取均分时间点之后的第一个关键帧
+        vector<double> keyframes;
+        double duration = 0.0;
+        if (!VideoSource::probeKeyframes(video_path, keyframes, duration) || keyframes.empty()) {
+            cerr << "Error: Could not read keyframes from " << video_path << endl;
+            return;
+        }
+        vector<double> starts{keyframes.front()};
+        for (int i = 1; i < segments; i++) {
+            double target = keyframes.front() + (duration - keyframes.front()) * i / segments;
+            auto keyframe = std::lower_bound(keyframes.begin(), keyframes.end(), target);
+            if (keyframe != keyframes.end() && *keyframe > starts.back() + overlap) {
+                starts.push_back(*keyframe);
+            }
+        }
+
+        Detect detect(model_dir);
+        double fps = 0.0;
+        cv::Size frame_size;
+        {
+            VideoSource probe;
+            if (!probe.open(video_path, VideoSource::Options())) {
+                cerr << "Error: Could not open video from " << video_path << endl;
+                return;
+            }
+            fps = probe.getFps();
+            frame_size = probe.getSourceSize();
+        }
+
+        // 每个分段处理到下一分段起点之后 overlap 秒，重叠窗口结束处交接
+        vector<TrackletStitcher::Handover> handovers;
+        vector<double> ends;
+        for (size_t i = 0; i < starts.size(); i++) {
+            if (i + 1 < starts.size()) {
+                ends.push_back(starts[i + 1] + overlap);
+                TrackletStitcher::Handover handover;
+                handover.overlapBegin = frame_index(starts[i + 1], fps);
+                handover.frame = frame_index(starts[i + 1] + overlap, fps);
+                handovers.push_back(handover);
+            } else {
+                ends.push_back(std::numeric_limits<double>::infinity());
+            }
+        }
+        cout << "Tracking " << starts.size() << " segments in parallel..." << endl;
+
+        int decode_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / static_cast<int>(starts.size()));
+        vector<vector<TrackRecord>> results(starts.size());
+        vector<string> errors(starts.size());
+        vector<std::thread> workers;
+        for (size_t i = 0; i < starts.size(); i++) {
+            workers.emplace_back([&, i]() {
+                try {
+                    results[i] = track_segment(detect, video_path, starts[i], ends[i], target_class, decode_threads);
+                } catch (const exception& e) {
+                    errors[i] = e.what();
+                }
+            });
+        }
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        for (size_t i = 0; i < starts.size(); i++) {
+            if (!errors[i].empty()) {
+                cerr << "Error: segment " << i << ": " << errors[i] << endl;
+                return;
+            }
+            cout << "Segment " << i << " from " << starts[i] << "s: " << results[i].size() << " track records" << endl;
+        }
+
+        TrackletStitcher stitcher(stitchOptions);
+        vector<TrackRecord> records = stitcher.stitch(results, handovers);
+        cout << "Stitched " << stitcher.getGlobalTracks() << " tracks (overlap links: " << stitcher.getOverlapLinks()
+             << ", gap links: " << stitcher.getGapLinks() << ")" << endl;
+
+        if (output_path.empty()) {
+            return;
+        }
+        if (output_path.size() > 4 && output_path.compare(output_path.size() - 4, 4, ".txt") == 0) {
+            // MOT格式：帧号（从1开始）,ID,x,y,w,h,置信度,-1,-1,-1
+            ofstream out(output_path);
+            for (const TrackRecord &record : records) {
+                out << record.frame + 1 << "," << record.id << ","
+                    << record.box.x << "," << record.box.y << "," << record.box.width << "," << record.box.height << ","
+                    << record.score << ",-1,-1,-1" << "\n";
+            }
+            cout << "Result saved to: " << output_path << endl;
+            return;
+        }
+
+        // 顺序解码一遍，按帧序号取出拼接后的结果绘制
+        VideoSource cap;
+        AsyncWriter<cv::Mat> writer(8);
+        if (!cap.open(video_path, VideoSource::Options()) ||
+            !writer.open(output_path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps, frame_size, 1.0,
+                         [](cv::Mat &image) -> cv::Mat & { return image; })) {
+            cerr << "Error: Could not create video writer for " << output_path << endl;
+            return;
+        }
+        BYTETracker palette(fps, 30);
+        size_t next = 0;
+        cv::Mat frame;
+        while (cap.read(frame)) {
+            int64_t index = frame_index(cap.getTimestamp(), fps);
+            while (next < records.size() && records[next].frame < index) {
+                next++;
+            }
+            for (; next < records.size() && records[next].frame == index; next++) {
+                cv::Rect box = records[next].box;
+                cv::rectangle(frame, box, palette.get_color(records[next].id), 2, 8);
+                cv::putText(frame, to_string(records[next].id), cv::Point(box.x, box.y - 10),
+                            cv::FONT_HERSHEY_SIMPLEX, 0.5, palette.get_color(records[next].id), 2);
+            }
+            writer.write(frame);
+            frame = cv::Mat();
+        }
+        writer.close();
+        cout << "Result saved to: " << output_path << endl;
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+    }
+}
+
 /**
  * @brief 主函数
  * 
@@ -188,7 +710,13 @@ int main(int argc, char* argv[]) {
     string output_path = (argc > 3) ? argv[3] : "";
     string target_class = (argc > 4) ? argv[4] : "person";
 
-    // 开始执行目标跟踪任务
-    object_tracking(model_dir, video_path, output_path, target_class);
+    // param.map 中 segments 大于1时离线分段并行跟踪，否则逐帧顺序跟踪
+    string paramPath = model_dir + "/param.map";
+    unordered_map<string, string> paramMap = readMap(paramPath);
+    if (paramMap.count("segments") && stoi(paramMap["segments"]) > 1) {
+        segment_tracking(model_dir, video_path, output_path, target_class, paramMap);
+    } else {
+        object_tracking(model_dir, video_path, output_path, target_class);
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,184 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <thread>
+#include "Include.h"
+#include "IngestQueue.h"
+
+/**
+ * @brief 异步视频写入
+ *
+ * 写入请求进入有界队列，由独立的编码线程取出、按需缩小并叠加绘制后编码，
+ * 检测流程只做一次入队。队列满时按过载策略阻塞或丢弃最旧的帧。
+ * 元素在编码完成前一直持有（如帧池槽位引用），帧池需为队列预留槽位。
+ *
+ * @tparam T 写入元素类型（需可默认构造和移动赋值）
+ */
+template <typename T>
+class AsyncWriter
+{
+public:
+    typedef std::function<cv::Mat &(T &)> ImageGetter;      // 取出元素中的图像
+    typedef std::function<void(T &, cv::Mat &)> Overlay;     // 在输出图像上叠加绘制
+
+    /**
+     * @brief 构造函数
+     *
+     * @param capacity 队列容量
+     * @param policy 队列满时的过载策略（OVERLOAD_BLOCK 或 OVERLOAD_DROP_OLDEST）
+     */
+    AsyncWriter(size_t capacity, OverloadPolicy policy = OVERLOAD_BLOCK)
+        : queue(capacity, policy), written(0)
+    {
+    }
+
+    AsyncWriter(const AsyncWriter &) = delete;
+    AsyncWriter &operator=(const AsyncWriter &) = delete;
+
+    /**
+     * @brief 析构函数，写完队列中的帧后关闭文件
+     */
+    ~AsyncWriter()
+    {
+        this->close();
+    }
+
+    /**
+     * @brief 打开输出文件并启动编码线程
+     *
+     * @param path 输出路径
+     * @param fourcc 编码格式
+     * @param fps 帧率
+     * @param frameSize 输入图像尺寸
+     * @param scale 输出缩放比例（小于1时先缩小再叠加绘制）
+     * @param getter 取出元素中的图像
+     * @param overlay 叠加绘制函数，为空表示图像已绘制完成
+     * @return bool 打开失败返回false
+     */
+    bool open(const string &path,
+              int fourcc,
+              double fps,
+              const cv::Size &frameSize,
+              double scale,
+              ImageGetter getter,
+              Overlay overlay = Overlay())
+    {
+        this->outputSize = frameSize;
+        if (scale > 0 && scale < 1)
+        {
+            // 常用编码器按4:2:0采样，宽高取偶数
+            this->outputSize = cv::Size(std::max(2, static_cast<int>(frameSize.width * scale) & ~1),
+                                        std::max(2, static_cast<int>(frameSize.height * scale) & ~1));
+        }
+        if (!this->writer.open(path, fourcc, fps, this->outputSize))
+        {
+            return false;
+        }
+        this->getter = getter;
+        this->overlay = overlay;
+        this->thread = std::thread(&AsyncWriter::run, this);
+        return true;
+    }
+
+    /**
+     * @brief 是否已打开
+     */
+    bool isOpened() const
+    {
+        return this->thread.joinable();
+    }
+
+    /**
+     * @brief 提交一帧（队列满时按过载策略阻塞或丢弃最旧的帧）
+     *
+     * @param item 元素
+     * @return bool 已关闭返回false
+     */
+    bool write(T item)
+    {
+        return this->queue.offer(std::move(item));
+    }
+
+    /**
+     * @brief 写完队列中的帧后关闭文件
+     */
+    void close()
+    {
+        this->queue.close();
+        if (this->thread.joinable())
+        {
+            this->thread.join();
+        }
+        this->writer.release();
+    }
+
+    /**
+     * @brief 输出尺寸
+     */
+    cv::Size getOutputSize() const
+    {
+        return this->outputSize;
+    }
+
+    /**
+     * @brief 已编码的帧数
+     */
+    uint64_t getWritten() const
+    {
+        return this->written.load();
+    }
+
+    /**
+     * @brief 因队列满被丢弃的帧数
+     */
+    uint64_t getDropped() const
+    {
+        return this->queue.getDropped();
+    }
+
+private:
+    /**
+     * @brief 编码线程主循环
+     */
+    void run()
+    {
+        T item;
+        cv::Mat canvas;
+        while (this->queue.pop(item))
+        {
+            cv::Mat &image = this->getter(item);
+            if (!this->overlay && image.size() == this->outputSize)
+            {
+                this->writer.write(image);
+            }
+            else
+            {
+                // 在编码线程自己的画布上缩小和绘制，不修改共享的原图
+                if (image.size() != this->outputSize)
+                {
+                    cv::resize(image, canvas, this->outputSize, 0, 0, cv::INTER_AREA);
+                }
+                else
+                {
+                    image.copyTo(canvas);
+                }
+                if (this->overlay)
+                {
+                    this->overlay(item, canvas);
+                }
+                this->writer.write(canvas);
+            }
+            this->written.fetch_add(1);
+            // 及时释放元素持有的资源（如帧缓冲引用）
+            item = T();
+        }
+    }
+
+    IngestQueue<T> queue;               // 待编码队列
+    cv::VideoWriter writer;             // 视频写入器
+    cv::Size outputSize;                // 输出尺寸
+    ImageGetter getter;                 // 取出元素中的图像
+    Overlay overlay;                    // 叠加绘制函数
+    std::thread thread;                 // 编码线程
+    std::atomic<uint64_t> written;      // 已编码的帧数
+};
@@ -27,8 +27,29 @@ public:
 
     // 更新跟踪器状态
     // param objects 检测结果列表
+    // param dt 距上一帧的时间间隔（以帧为单位）
     // \return 当前帧的跟踪结果
-    std::vector<STrack> update(const std::vector<detect_result>& objects);
+    std::vector<STrack> update(const std::vector<detect_result>& objects, float dt = 1.f);
+
+    // 无检测结果的帧：只按运动模型预测轨迹位置，不做关联
+    // param dt 距上一帧的时间间隔（以帧为单位）
+    // \return 当前帧的跟踪结果（预测位置）
+    std::vector<STrack> predict(float dt = 1.f);
+
+    // 预测已确认轨迹在下一帧的位置（不修改跟踪状态）
+    // param dt 距上一帧的时间间隔（以帧为单位）
+    // \return 预测框 [x, y, width, height]
+    std::vector<cv::Rect_<float>> predict_boxes(float dt = 1.f) const;
+
+    // 已确认轨迹的最大位置不确定度
+    // \return 中心点位置标准差与框高之比的最大值，没有轨迹时为0
+    float max_uncertainty() const;
+
+    // 待确认的新轨迹数（出现后尚未在下一次检测中再次匹配）
+    int unconfirmed_count() const;
+
+    // 丢失中的轨迹数
+    int lost_count() const;
     
     // 获取指定索引的颜色
     // param idx 颜色索引
@@ -0,0 +1,140 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 延迟目标下的自适应批量控制器
+ *
+ * 在线记录每批推理耗时（按批量分别做指数滑动平均，样本不足的批量按 固定开销 + 逐帧耗时 线性拟合估计）、
+ * 进入推理级的帧率和端到端延迟。每个调整周期按估计模型，在凑批等待时间内能凑满的批量中，
+ * 选出吞吐满足到达帧率、预计p95延迟不超过目标的最大批量及对应的凑批等待时间；
+ * 实测p95超出目标时在此基础上收缩批量和等待时间。当前决策和原因可通过 report() 输出。
+ */
+class BatchController
+{
+public:
+    typedef std::function<void(size_t, int64_t)> Apply;    // 应用决策：批量、凑批等待时间（微秒）
+
+    /**
+     * @brief 控制参数
+     */
+    struct Options
+    {
+        size_t maxBatch = 1;            // 批量上限（模型支持的最大批量）
+        int workers = 1;                // 推理线程数
+        double targetMs = 100.0;        // 端到端p95延迟目标（毫秒）
+        int64_t minWaitUs = 0;          // 凑批等待时间下限（微秒）
+        int64_t maxWaitUs = 10000;      // 凑批等待时间上限（微秒）
+        int64_t intervalMs = 500;       // 调整周期（毫秒）
+    };
+
+    /**
+     * @brief 一次决策
+     */
+    struct Decision
+    {
+        size_t batch = 1;               // 批量
+        int64_t waitUs = 0;             // 凑批等待时间（微秒）
+        double p95Ms = 0.0;             // 上个周期实测的p95端到端延迟（毫秒）
+        double arrivalFps = 0.0;        // 上个周期进入推理级的帧率
+        double inferMs = 0.0;           // 该批量的预计单批推理耗时（毫秒）
+        double capacityFps = 0.0;       // 该批量的预计推理吞吐（帧/秒）
+        uint64_t updates = 0;           // 调整次数
+        std::string reason;             // 原因
+    };
+
+    /**
+     * @brief 构造函数
+     *
+     * @param options 控制参数
+     * @param initialBatch 初始批量
+     * @param initialWaitUs 初始凑批等待时间（微秒）
+     * @param apply 应用决策的函数（在记录推理耗时的线程中调用）
+     */
+    BatchController(const Options &options, size_t initialBatch, int64_t initialWaitUs, Apply apply);
+
+    BatchController(const BatchController &) = delete;
+    BatchController &operator=(const BatchController &) = delete;
+
+    /**
+     * @brief 记录进入推理流水线的帧
+     *
+     * @param count 帧数
+     */
+    void recordArrival(size_t count = 1);
+
+    /**
+     * @brief 记录一批推理耗时，到达调整周期时重新决策
+     *
+     * @param batch 批量
+     * @param inferUs 推理耗时（微秒）
+     */
+    void recordBatch(size_t batch, int64_t inferUs);
+
+    /**
+     * @brief 记录一帧的端到端延迟（解码到输出）
+     *
+     * @param latencyUs 延迟（微秒）
+     */
+    void recordLatency(int64_t latencyUs);
+
+    /**
+     * @brief 当前决策
+     */
+    Decision getDecision() const;
+
+    /**
+     * @brief 格式化当前决策
+     *
+     * @return std::string 一行：批量、等待时间、实测p95、到达帧率、预计耗时和吞吐、原因
+     */
+    std::string report() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief 单个批量的推理耗时统计
+     */
+    struct BatchTime
+    {
+        double ewmaUs = 0.0;            // 指数滑动平均耗时（微秒）
+        uint64_t count = 0;             // 样本数
+    };
+
+    /**
+     * @brief 按上个周期的统计重新决策（需持有锁）
+     *
+     * @param seconds 周期时长（秒）
+     */
+    void tune(double seconds);
+
+    /**
+     * @brief 估计单批推理耗时（需持有锁）
+     *
+     * @param batch 批量
+     * @return double 耗时（微秒），没有任何样本时为0
+     */
+    double estimateUs(size_t batch) const;
+
+    /**
+     * @brief 延迟样本的p95（需持有锁）
+     *
+     * @return double p95延迟（微秒），没有样本时为0
+     */
+    double latencyP95Us();
+
+    Options options;                        // 控制参数
+    Apply apply;                            // 应用决策的函数
+    mutable std::mutex mutex;               // 保护以下成员
+    std::vector<BatchTime> times;           // 各批量的推理耗时（下标为批量）
+    std::vector<int64_t> latencies;         // 本周期的延迟样本
+    uint64_t latencySeen;                   // 本周期记录的延迟数（样本满后按轮转替换）
+    Clock::time_point lastTune;             // 上次调整时间
+    Decision decision;                      // 当前决策
+    std::atomic<uint64_t> arrivals;         // 本周期进入推理流水线的帧数
+};
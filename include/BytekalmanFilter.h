@@ -21,7 +21,8 @@ namespace byte_kalman
 		// 预测步骤：根据运动模型预测下一时刻的状态
 		// 参数：mean - 状态均值（输入输出）
 		//      covariance - 状态协方差（输入输出）
-		void predict(KAL_MEAN& mean, KAL_COVA& covariance);
+		//      dt - 时间间隔（以帧为单位，跳帧或帧间隔不均匀时不为1）
+		void predict(KAL_MEAN& mean, KAL_COVA& covariance, float dt = 1.f);
 		
 		// 投影函数：将状态空间投影到观测空间
 		// 参数：mean - 状态均值
@@ -3,6 +3,39 @@
 #include "Model.h"
 #include "Transformer.h"
 
+/**
+ * @brief 模型输出解码方式
+ *
+ * 根据模型输出形状自动选择，无需在导出时额外转置。
+ */
+enum DecodeMode
+{
+    DECODE_ANCHOR_MAJOR = 0,     // [N, 5+C]，含目标置信度（YOLOv5/v6/v7）
+    DECODE_CHANNEL_MAJOR = 1,    // [4+C, N]，无目标置信度（YOLOv8/v11）
+    DECODE_RAW_HEAD = 2,         // 多个 [na, H, W, 5+C] 原始检测头输出（未做sigmoid）
+    DECODE_END_TO_END_XYXY = 3,  // [K, 6]：x1, y1, x2, y2, score, class（YOLOv10，无需NMS）
+    DECODE_END_TO_END_NORM = 4,  // [K, 4+C]：归一化 cx, cy, w, h 与最终类别分数（RT-DETR，无需NMS）
+    DECODE_END_TO_END_SPLIT = 5, // labels [K]、boxes [K, 4]、scores [K] 三个输出（RT-DETR官方导出，无需NMS）
+    DECODE_ROW_MAJOR = 6         // [N, 4+C]，无目标置信度（YOLOv8/v11 转置导出）
+};
+
+/**
+ * @brief 原始检测头的单个尺度
+ *
+ * 网格偏移与锚框尺寸在构造时预先计算，解码时只需查表。
+ */
+struct HeadScale
+{
+    int gridHeight;              // 特征图高度
+    int gridWidth;               // 特征图宽度
+    int anchorNum;               // 锚框数量
+    float stride;                // 下采样步长
+    vector<float> offsetX;       // 每个网格的x偏移 (gx - 0.5) * stride
+    vector<float> offsetY;       // 每个网格的y偏移 (gy - 0.5) * stride
+    vector<float> anchorWidth;   // 4 * 锚框宽度
+    vector<float> anchorHeight;  // 4 * 锚框高度
+};
+
 /**
  * @brief 目标检测基类
  * 
@@ -25,6 +58,14 @@ public:
      */
     Detect(string dir);
 
+    /**
+     * @brief 带参数的构造函数，指定ORT计算线程绑定的CPU
+     * 
+     * @param dir 模型文件所在目录路径
+     * @param ortCpus ORT计算线程绑定的CPU编号（覆盖 param.map 中的 ort_cpus），为空表示不绑定
+     */
+    Detect(string dir, const vector<int> &ortCpus);
+
     /**
      * @brief 析构函数，负责释放模型资源
      */
@@ -37,6 +78,13 @@ public:
      */
     int getBatchSize();
 
+    /**
+     * @brief 获取模型输入尺寸
+     * 
+     * @return cv::Size 输入宽高（与该尺寸相同的图像预处理时不缩放）
+     */
+    cv::Size getInputSize();
+
     /**
      * @brief 获取类别数量
      * 
@@ -44,6 +92,13 @@ public:
      */
     int getClassNum();
 
+    /**
+     * @brief 获取类别名称列表
+     * 
+     * @return const vector<string>& 类别名称，下标即类别ID
+     */
+    const vector<string> &getClassNames();
+
     /**
      * @brief 获取非极大值抑制置信度阈值
      * 
@@ -75,12 +130,135 @@ public:
                          vector<vector<vector<cv::Point>>> &outputPoints,
                          vector<vector<vector<float>>> &outputPointConfidences);
 
+    /**
+     * @brief 单张图像预处理（letterbox缩放、填充、归一化）
+     * 
+     * @param image 输入图像
+     * @return Transformer 图像变换器（含模型输入矩阵）
+     */
+    Transformer preprocess(const cv::Mat &image);
+
+    /**
+     * @brief 预处理解码时已按letterbox比例缩放的图像
+     * 
+     * @param image 已缩放的输入图像
+     * @param sourceSize 缩放前的原始尺寸，后处理的坐标反变换回该坐标系
+     * @return Transformer 预处理结果
+     */
+    Transformer preprocess(const cv::Mat &image, const cv::Size &sourceSize);
+
+    /**
+     * @brief 批量推理（不解码），可被多个线程并发调用
+     * 
+     * @param inputImages 预处理后的模型输入矩阵列表
+     * @return vector<vector<cv::Mat>> 推理结果，下标依次为 [样本索引][输出索引]
+     */
+    vector<vector<cv::Mat>> infer(const vector<cv::Mat> &inputImages);
+
+    /**
+     * @brief 单张图像后处理（解码、NMS、坐标反变换）
+     * 
+     * @param outputs 单张图像的全部模型输出
+     * @param transformer 该图像预处理时的图像变换器
+     * @param outputRect 输出检测框
+     * @param outputName 输出类别名称
+     * @param outputConfidence 输出置信度
+     */
+    void postprocess(const vector<cv::Mat> &outputs,
+                     Transformer &transformer,
+                     vector<cv::Rect> &outputRect,
+                     vector<string> &outputName,
+                     vector<float> &outputConfidence);
+
     /**
      * @brief 预热模型，执行一次推理以初始化模型
      */
     virtual void warmup();
 
+    /**
+     * @brief 获取输出解码方式
+     * 
+     * @return DecodeMode 输出解码方式
+     */
+    DecodeMode getDecodeMode();
+
 protected:
+    /**
+     * @brief 根据模型输出形状选择解码方式
+     * 
+     * @return DecodeMode 输出解码方式
+     */
+    DecodeMode selectDecodeMode();
+
+    /**
+     * @brief 根据锚框配置预先计算各尺度的网格和锚框表
+     * 
+     * @param anchors 锚框配置，尺度间以";"分隔，同一尺度内以","分隔
+     */
+    void buildHeadScales(string anchors);
+
+    /**
+     * @brief 解码单张图像的模型输出
+     * 
+     * @param outputs 单张图像的全部模型输出
+     * @param boxes 输出检测框（模型输入坐标系）
+     * @param classIds 输出类别索引
+     * @param confidences 输出置信度
+     */
+    void decode(const vector<cv::Mat> &outputs,
+                vector<cv::Rect> &boxes,
+                vector<int> &classIds,
+                vector<float> &confidences);
+
+    /**
+     * @brief 解码 [N, 5+C] 布局的输出（每行一个候选框）
+     */
+    void decodeAnchorMajor(const cv::Mat &predict,
+                           vector<cv::Rect> &boxes,
+                           vector<int> &classIds,
+                           vector<float> &confidences);
+
+    /**
+     * @brief 解码 [4+C, N] 布局的输出（每行一个通道）
+     * 
+     * 直接按通道行读取，逐行连续扫描求类别最大值，不做转置拷贝。
+     * 类别行之后的附加通道（如分割的掩码系数）不参与解码，
+     * 可通过 anchorIds 取得保留框所在的列。
+     */
+    void decodeChannelMajor(const cv::Mat &predict,
+                            vector<cv::Rect> &boxes,
+                            vector<int> &classIds,
+                            vector<float> &confidences,
+                            vector<int> *anchorIds = nullptr);
+
+    /**
+     * @brief 解码 [N, 4+C] 布局的输出（每行一个候选框，无目标置信度）
+     */
+    void decodeRowMajor(const cv::Mat &predict,
+                        vector<cv::Rect> &boxes,
+                        vector<int> &classIds,
+                        vector<float> &confidences);
+
+    /**
+     * @brief 解码多尺度原始检测头输出
+     * 
+     * 先在logit空间比较目标置信度，只有通过阈值的网格才计算sigmoid和框变换。
+     */
+    void decodeRawHead(const vector<cv::Mat> &outputs,
+                       vector<cv::Rect> &boxes,
+                       vector<int> &classIds,
+                       vector<float> &confidences);
+
+    /**
+     * @brief 解码端到端（集合预测）输出
+     * 
+     * 固定K个查询，分数已是最终分数，只做阈值过滤，不做NMS。
+     */
+    void decodeEndToEnd(const vector<cv::Mat> &outputs,
+                        vector<cv::Rect> &boxes,
+                        vector<int> &classIds,
+                        vector<float> &confidences);
+
     int batchSize;                            //批处理大小
     vector<string> classNames;                // 类别名称列表
     Model *model;                             // 模型指针
@@ -88,5 +266,11 @@ protected:
     float objConf;                            // 目标置信度阈值
     int deviceId;                             // 设备ID
     bool useNms;                              // 是否使用非极大值抑制
+    DecodeMode decodeMode;                    // 输出解码方式
+    vector<HeadScale> headScales;             // 原始检测头各尺度的网格和锚框表
+    float objLogitThreshold;                  // 目标置信度阈值对应的logit
+    int labelsOutput;                         // 端到端拆分输出中 labels 的输出索引
+    int boxesOutput;                          // 端到端拆分输出中 boxes 的输出索引
+    int scoresOutput;                         // 端到端拆分输出中 scores 的输出索引
 
 };
\ No newline at end of file
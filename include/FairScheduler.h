@@ -0,0 +1,230 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "IngestQueue.h"
+
+/**
+ * @brief 多路输入之间的调度方式
+ */
+enum SchedulePolicy
+{
+    SCHEDULE_ROUND_ROBIN = 0,    // 轮询，每路每轮最多取一个
+    SCHEDULE_DEFICIT = 1         // 差额轮询（DRR），每路按权重累积额度
+};
+
+/**
+ * @brief 解析调度方式名称
+ *
+ * @param name round_robin / deficit
+ * @return SchedulePolicy 调度方式，无法识别时为轮询
+ */
+inline SchedulePolicy parseSchedulePolicy(const std::string &name)
+{
+    return name == "deficit" ? SCHEDULE_DEFICIT : SCHEDULE_ROUND_ROBIN;
+}
+
+/**
+ * @brief 多路输入公平调度器
+ *
+ * 每路输入有独立的接收队列（各自的过载策略和丢弃计数），
+ * 单个调度线程通过 next() 按轮询或差额轮询依次从各路取出元素，
+ * 下游饱和时各路按权重分享处理能力，空闲的输入不累积额度。
+ *
+ * @tparam T 元素类型（需可默认构造和移动赋值）
+ */
+template <typename T>
+class FairScheduler
+{
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param streamNum 输入路数
+     * @param capacity 每路接收队列容量
+     * @param policy 调度方式
+     * @param overload 每路的过载策略
+     * @param dropInterval OVERLOAD_DROP_NTH 时每隔多少个元素丢弃一个
+     */
+    FairScheduler(size_t streamNum,
+                  size_t capacity,
+                  SchedulePolicy policy = SCHEDULE_ROUND_ROBIN,
+                  OverloadPolicy overload = OVERLOAD_BLOCK,
+                  int dropInterval = 2)
+        : policy(policy), quantum(streamNum, 1.0), deficit(streamNum, 0.0), served(new std::atomic<uint64_t>[streamNum]), cursor(0)
+    {
+        for (size_t i = 0; i < streamNum; i++)
+        {
+            this->queues.emplace_back(new IngestQueue<T>(capacity, overload, dropInterval));
+            this->served[i].store(0);
+        }
+        if (streamNum > 0)
+        {
+            this->deficit[0] = this->quantum[0];
+        }
+    }
+
+    /**
+     * @brief 设置某一路的权重（差额轮询每轮累积的额度）
+     *
+     * @param stream 输入序号
+     * @param weight 权重
+     */
+    void setWeight(size_t stream, double weight)
+    {
+        this->quantum.at(stream) = std::max(1.0, weight);
+    }
+
+    /**
+     * @brief 按该路的过载策略放入元素
+     *
+     * @param stream 输入序号
+     * @param item 元素
+     * @return bool 该路已关闭返回false
+     */
+    bool offer(size_t stream, T item)
+    {
+        bool accepted = this->queues[stream]->offer(std::move(item));
+        this->event.notifyOne();
+        return accepted;
+    }
+
+    /**
+     * @brief 某一路输入结束
+     *
+     * @param stream 输入序号
+     */
+    void closeStream(size_t stream)
+    {
+        this->queues[stream]->close();
+        this->event.notifyAll();
+    }
+
+    /**
+     * @brief 关闭全部输入（可在信号处理函数中调用）
+     */
+    void close()
+    {
+        for (const std::unique_ptr<IngestQueue<T>> &queue : this->queues)
+        {
+            queue->close();
+        }
+        this->event.notifyAll();
+    }
+
+    /**
+     * @brief 按调度方式取出下一个元素（只允许单个调度线程调用）
+     *
+     * @param item 输出元素
+     * @param stream 输出元素所属的输入序号
+     * @return bool 全部输入已结束且取空返回false
+     */
+    bool next(T &item, size_t &stream)
+    {
+        while (true)
+        {
+            uint32_t key = this->event.prepareWait();
+            if (this->pick(item, stream))
+            {
+                this->event.cancelWait();
+                return true;
+            }
+            if (this->finished())
+            {
+                this->event.cancelWait();
+                return false;
+            }
+            this->event.wait(key);
+        }
+    }
+
+    /**
+     * @brief 输入路数
+     */
+    size_t getStreamNum() const
+    {
+        return this->queues.size();
+    }
+
+    /**
+     * @brief 某一路的接收队列（用于查询丢弃计数等）
+     */
+    const IngestQueue<T> &getQueue(size_t stream) const
+    {
+        return *this->queues[stream];
+    }
+
+    /**
+     * @brief 某一路已调度出的元素数
+     */
+    uint64_t getServed(size_t stream) const
+    {
+        return this->served[stream].load();
+    }
+
+private:
+    /**
+     * @brief 按调度方式非阻塞地选出下一个元素
+     */
+    bool pick(T &item, size_t &stream)
+    {
+        const size_t streamNum = this->queues.size();
+        for (size_t visited = 0; visited <= streamNum && streamNum > 0; visited++)
+        {
+            size_t i = this->cursor;
+            if (this->policy == SCHEDULE_ROUND_ROBIN)
+            {
+                this->cursor = (this->cursor + 1) % streamNum;
+                if (this->queues[i]->tryPop(item))
+                {
+                    stream = i;
+                    this->served[i].fetch_add(1);
+                    return true;
+                }
+                continue;
+            }
+
+            // 差额轮询：额度足够时留在当前输入，否则换到下一路并为其累积额度
+            if (this->deficit[i] >= 1.0 && this->queues[i]->tryPop(item))
+            {
+                this->deficit[i] -= 1.0;
+                stream = i;
+                this->served[i].fetch_add(1);
+                return true;
+            }
+            if (this->queues[i]->size() == 0)
+            {
+                // 空闲的输入不累积额度，避免恢复后突发抢占
+                this->deficit[i] = 0.0;
+            }
+            this->cursor = (this->cursor + 1) % streamNum;
+            this->deficit[this->cursor] += this->quantum[this->cursor];
+        }
+        return false;
+    }
+
+    /**
+     * @brief 全部输入是否已关闭且取空
+     */
+    bool finished() const
+    {
+        for (const std::unique_ptr<IngestQueue<T>> &queue : this->queues)
+        {
+            if (!queue->isClosed() || queue->size() > 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<std::unique_ptr<IngestQueue<T>>> queues;    // 每路的接收队列
+    SchedulePolicy policy;                                   // 调度方式
+    std::vector<double> quantum;                             // 每路每轮累积的额度
+    std::vector<double> deficit;                             // 每路当前额度
+    std::unique_ptr<std::atomic<uint64_t>[]> served;        // 每路已调度出的元素数
+    size_t cursor;                                           // 当前输入
+    EventCount event;                                        // 任一路有新元素或关闭
+};
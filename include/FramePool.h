@@ -0,0 +1,119 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include "Include.h"
+#include "MpmcQueue.h"
+
+class FramePool;
+
+/**
+ * @brief 帧缓冲引用
+ *
+ * 指向帧池中一个槽位的引用计数句柄（侵入式计数，拷贝不分配内存）。
+ * 最后一个引用析构时槽位自动归还帧池。
+ */
+class FrameRef
+{
+public:
+    /**
+     * @brief 默认构造函数，空引用
+     */
+    FrameRef();
+
+    /**
+     * @brief 拷贝构造函数，引用计数加一
+     */
+    FrameRef(const FrameRef &other);
+
+    /**
+     * @brief 移动构造函数
+     */
+    FrameRef(FrameRef &&other) noexcept;
+
+    /**
+     * @brief 赋值运算符
+     */
+    FrameRef &operator=(FrameRef other) noexcept;
+
+    /**
+     * @brief 析构函数，引用计数减一，归零时归还槽位
+     */
+    ~FrameRef();
+
+    /**
+     * @brief 获取槽位中的图像
+     *
+     * @return cv::Mat& 图像（与槽位共享内存）
+     */
+    cv::Mat &image() const;
+
+    /**
+     * @brief 是否为空引用
+     */
+    bool empty() const;
+
+    /**
+     * @brief 释放引用
+     */
+    void reset();
+
+private:
+    friend class FramePool;
+
+    FrameRef(FramePool *pool, int slot);
+
+    FramePool *pool;    // 所属帧池
+    int slot;           // 槽位序号，-1表示空
+};
+
+/**
+ * @brief 帧缓冲池
+ *
+ * 按视频流分辨率一次性预分配固定数量的帧缓冲，解码直接写入空闲槽位，
+ * 作业结果被消费后通过 FrameRef 的引用计数归还，稳态下不再分配帧内存。
+ */
+class FramePool
+{
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param size 槽位数量（需大于同时在途的最大帧数）
+     * @param width 帧宽度
+     * @param height 帧高度
+     * @param type 像素类型
+     */
+    FramePool(int size, int width, int height, int type = CV_8UC3);
+
+    /**
+     * @brief 获取空闲槽位，没有空闲槽位时阻塞等待
+     *
+     * @return FrameRef 槽位引用，帧池已关闭时返回空引用
+     */
+    FrameRef acquire();
+
+    /**
+     * @brief 关闭帧池，唤醒等待中的 acquire()
+     */
+    void close();
+
+    /**
+     * @brief 槽位总数
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief 当前空闲槽位数（近似值）
+     */
+    size_t available() const;
+
+private:
+    friend class FrameRef;
+
+    void retain(int slot);
+    void release(int slot);
+
+    std::vector<cv::Mat> frames;                        // 预分配的帧缓冲
+    std::unique_ptr<std::atomic<int>[]> refCounts;      // 每个槽位的引用计数
+    MpmcQueue<int> freeSlots;                           // 空闲槽位
+};
@@ -40,6 +40,46 @@ vector<string> stringSplit(string &str, string delim);
  */
 unordered_map<string, string> readMap(string &fileName);
 
+/**
+ * @brief 解析CPU编号列表
+ * 
+ * @param cpus 形如 "0-3,8,10-11" 的CPU编号列表，空字符串表示不限制
+ * @return vector<int> CPU编号
+ */
+vector<int> parseCpuList(const string &cpus);
+
+/**
+ * @brief 获取在线的NUMA节点编号
+ * 
+ * @return vector<int> 节点编号，系统不支持NUMA时为 {0}
+ */
+vector<int> numaNodes();
+
+/**
+ * @brief 获取NUMA节点上的CPU编号
+ * 
+ * @param node 节点编号
+ * @return vector<int> CPU编号，无法读取时为空
+ */
+vector<int> numaNodeCpus(int node);
+
+/**
+ * @brief CPU集合求交集
+ * 
+ * @param cpus CPU编号
+ * @param allowed 允许的CPU编号
+ * @return vector<int> 同时出现在两者中的CPU编号（保持 cpus 中的顺序）
+ */
+vector<int> intersectCpus(const vector<int> &cpus, const vector<int> &allowed);
+
+/**
+ * @brief 将调用线程绑定到指定CPU集合
+ * 
+ * @param cpus CPU编号，为空时不做任何操作
+ * @return bool 绑定成功或无需绑定返回true
+ */
+bool pinCurrentThread(const vector<int> &cpus);
+
 const int SKELETON_POINT_NUM = 19;                                      // 骨骼关键点数量
 
 const int SKELETON_FIRST[SKELETON_POINT_NUM] = {15, 13, 16, 14, 11, 5, 6, 5, 5, 6, 7, 8, 1, 0, 0, 1, 2, 3, 4};  // 骨骼连接线起始点索引
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "MpmcQueue.h"
+
+/**
+ * @brief 接收队列满（推理跟不上）时的过载策略
+ */
+enum OverloadPolicy
+{
+    OVERLOAD_BLOCK = 0,          // 阻塞等待（处理每一帧，延迟无上限）
+    OVERLOAD_DROP_OLDEST = 1,    // 丢弃队列中最旧的元素
+    OVERLOAD_KEEP_LATEST = 2,    // 只保留最新的元素，丢弃队列中全部积压
+    OVERLOAD_DROP_NTH = 3        // 积压超过半队列时每N个丢弃一个，否则阻塞
+};
+
+/**
+ * @brief 解析过载策略名称
+ *
+ * @param name block / drop_oldest / keep_latest / drop_nth
+ * @return OverloadPolicy 过载策略，无法识别时为阻塞
+ */
+inline OverloadPolicy parseOverloadPolicy(const std::string &name)
+{
+    if (name == "drop_oldest")
+    {
+        return OVERLOAD_DROP_OLDEST;
+    }
+    if (name == "keep_latest")
+    {
+        return OVERLOAD_KEEP_LATEST;
+    }
+    if (name == "drop_nth")
+    {
+        return OVERLOAD_DROP_NTH;
+    }
+    return OVERLOAD_BLOCK;
+}
+
+/**
+ * @brief 带过载策略的接收队列
+ *
+ * 在有界无锁队列之上按过载策略决定队列满时阻塞还是丢弃，
+ * 被丢弃的元素直接析构（释放其持有的资源），并按策略计数。
+ *
+ * @tparam T 元素类型（需可默认构造和移动赋值）
+ */
+template <typename T>
+class IngestQueue
+{
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param capacity 队列容量（只保留最新元素时固定为1）
+     * @param policy 过载策略
+     * @param dropInterval OVERLOAD_DROP_NTH 时每隔多少个元素丢弃一个
+     */
+    IngestQueue(size_t capacity, OverloadPolicy policy = OVERLOAD_BLOCK, int dropInterval = 2)
+        : queue(policy == OVERLOAD_KEEP_LATEST ? 1 : capacity),
+          policy(policy),
+          dropInterval(std::max(2, dropInterval)),
+          offered(0),
+          dropped(0)
+    {
+    }
+
+    /**
+     * @brief 按过载策略放入元素
+     *
+     * @param item 元素
+     * @return bool 队列已关闭返回false
+     */
+    bool offer(T item)
+    {
+        uint64_t index = this->offered.fetch_add(1);
+        T stale;
+        switch (this->policy)
+        {
+        case OVERLOAD_DROP_OLDEST:
+        case OVERLOAD_KEEP_LATEST:
+            // 容量为1时丢弃最旧即只保留最新
+            while (!this->queue.tryPush(item))
+            {
+                if (this->queue.isClosed())
+                {
+                    return false;
+                }
+                if (this->queue.tryPop(stale))
+                {
+                    this->dropped.fetch_add(1);
+                }
+            }
+            return true;
+        case OVERLOAD_DROP_NTH:
+            if (this->queue.size() * 2 >= this->queue.capacity() && index % this->dropInterval == 0)
+            {
+                this->dropped.fetch_add(1);
+                return !this->queue.isClosed();
+            }
+            return this->queue.push(std::move(item));
+        default:
+            return this->queue.push(std::move(item));
+        }
+    }
+
+    /**
+     * @brief 非阻塞取出元素
+     */
+    bool tryPop(T &item)
+    {
+        return this->queue.tryPop(item);
+    }
+
+    /**
+     * @brief 阻塞取出元素
+     */
+    bool pop(T &item)
+    {
+        return this->queue.pop(item);
+    }
+
+    /**
+     * @brief 关闭队列
+     */
+    void close()
+    {
+        this->queue.close();
+    }
+
+    /**
+     * @brief 队列是否已关闭
+     */
+    bool isClosed() const
+    {
+        return this->queue.isClosed();
+    }
+
+    /**
+     * @brief 当前元素数量（近似值）
+     */
+    size_t size() const
+    {
+        return this->queue.size();
+    }
+
+    /**
+     * @brief 过载策略
+     */
+    OverloadPolicy getPolicy() const
+    {
+        return this->policy;
+    }
+
+    /**
+     * @brief 放入的元素总数（含被丢弃的）
+     */
+    uint64_t getOffered() const
+    {
+        return this->offered.load();
+    }
+
+    /**
+     * @brief 被过载策略丢弃的元素数
+     */
+    uint64_t getDropped() const
+    {
+        return this->dropped.load();
+    }
+
+private:
+    MpmcQueue<T> queue;                 // 有界队列
+    OverloadPolicy policy;              // 过载策略
+    int dropInterval;                   // 每隔多少个元素丢弃一个
+    std::atomic<uint64_t> offered;      // 放入总数
+    std::atomic<uint64_t> dropped;      // 丢弃数
+};
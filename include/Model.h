@@ -12,15 +12,21 @@ class Model
 private:
     size_t num_input_nodes;              // 输入节点数量
     vector<string> input_node_names;     // 输入节点名称列表
-    vector<int64_t> input_node_dims;     // 输入节点维度信息
+    vector<int64_t> input_node_dims;     // 输入节点维度信息（第一个输入，即图像）
+    vector<vector<int64_t>> input_node_dims_list;   // 每个输入节点的维度信息
+    vector<ONNXTensorElementDataType> input_node_types;  // 每个输入节点的数据类型
+    unordered_map<string, vector<int64_t>> aux_inputs;   // 附加输入（除图像外）的单样本取值
 
     int64_t input_dim_product;           // 输入维度乘积（批量大小除外）
 
     size_t num_output_nodes;             // 输出节点数量
     vector<string> output_node_names;    // 输出节点名称列表
-    vector<int64_t> output_node_dims;    // 输出节点维度信息
+    vector<int64_t> output_node_dims;    // 输出节点维度信息（第一个输出）
+    vector<vector<int64_t>> output_node_dims_list;  // 每个输出节点的维度信息
 
-    int64_t output_dim_produt;           // 输出维度乘积（批量大小除外）
+    int64_t output_dim_produt;           // 输出维度乘积（批量大小除外，第一个输出）
+    vector<int64_t> output_dim_products; // 每个输出的维度乘积（批量大小除外）
+    vector<ONNXTensorElementDataType> output_node_types; // 每个输出节点的数据类型
 
     Ort::Session *ort_session;           // ONNX Runtime会话对象
     Ort::Env *env;                       // ONNX Runtime环境对象
@@ -59,6 +65,17 @@ public:
      */
     Model(const char *onnxPath, const int NumThread, const char *envName, const int cudaId);
 
+    /**
+     * @brief 构造函数，CPU推理时将ORT计算线程绑定到指定CPU
+     * 
+     * @param onnxPath ONNX模型文件路径
+     * @param NumThread CPU推理线程数，cpus非空时取cpus的个数
+     * @param envName 环境名称
+     * @param cudaId CUDA设备ID，-1表示使用CPU
+     * @param cpus ORT计算线程绑定的CPU编号，为空表示不绑定
+     */
+    Model(const char *onnxPath, const int NumThread, const char *envName, const int cudaId, const vector<int> &cpus);
+
     /**
      * @brief 获取输入节点数量
      * 
@@ -80,6 +97,25 @@ public:
      */
     const vector<int64_t> getInputDims();
 
+    /**
+     * @brief 设置附加输入的取值
+     * 
+     * 用于除图像外还需要其他输入的模型（如RT-DETR的 orig_target_sizes），
+     * 推理时按批量大小重复填充。
+     * 
+     * @param name 输入节点名称
+     * @param values 单个样本的取值
+     */
+    void setAuxInput(const string &name, const vector<int64_t> &values);
+
+    /**
+     * @brief 是否已设置附加输入的取值
+     * 
+     * @param name 输入节点名称
+     * @return bool 已通过 setAuxInput 设置返回true
+     */
+    bool hasAuxInput(const string &name) const;
+
     /**
      * @brief 获取输出节点数量
      * 
@@ -101,6 +137,14 @@ public:
      */
     const vector<int64_t> getOutputNodeDims();
 
+    /**
+     * @brief 获取指定输出节点的维度信息
+     * 
+     * @param index 输出节点索引
+     * @return const vector<int64_t> 输出节点维度信息
+     */
+    const vector<int64_t> getOutputNodeDims(size_t index);
+
     /**
      * @brief 打印模型信息
      * 
@@ -116,6 +160,16 @@ public:
      */
     vector<cv::Mat> predict(vector<cv::Mat> images);
 
+    /**
+     * @brief 执行模型推理并返回所有输出
+     * 
+     * 每个输出按样本切分为二维矩阵：行数为 dims[1]，列数为其余维度乘积。
+     * 
+     * @param images 预处理后的输入图像列表
+     * @return vector<vector<cv::Mat>> 推理结果，下标依次为 [输出索引][样本索引]
+     */
+    vector<vector<cv::Mat>> predictOutputs(vector<cv::Mat> images);
+
     /**
      * @brief 获取输入维度乘积
      * 
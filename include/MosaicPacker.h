@@ -0,0 +1,101 @@
+#pragma once
+#include "Include.h"
+
+/**
+ * @brief 马赛克拼图打包
+ *
+ * 将多个感兴趣区域（可来自不同视频流或同一帧）按货架算法（按高度降序，逐层从左到右放置）
+ * 以原始分辨率拼入模型输入尺寸的画布，一张画布只推理一次，小区域不再各自占用一次整幅推理。
+ * 推理后按检测框中心所在的区域拆分回各来源并反变换到来源图像坐标系；
+ * 区域之间留有间隔，跨出区域或贴在区域内部裁剪边界上（目标被截断）的检测框被过滤。
+ * 目前只有 luoyang_yolo_track 用于同一帧的裁剪区域；YoloJob 以整帧推理（通常不小于模型输入，
+ * 或已按 decode_size 缩放到模型输入尺寸），没有可拼入同一画布的局部区域，暂不使用。
+ */
+class MosaicPacker
+{
+public:
+    /**
+     * @brief 待打包的区域
+     */
+    struct Tile
+    {
+        int source = 0;             // 来源编号（如视频流序号）
+        cv::Mat image;              // 来源图像
+        cv::Rect roi;               // 区域（来源图像坐标系）
+    };
+
+    /**
+     * @brief 区域在画布上的位置
+     */
+    struct Placement
+    {
+        size_t tile = 0;            // 区域下标（打包输入中的下标）
+        cv::Rect rect;              // 画布上的位置
+        double scale = 1.0;         // 缩放比例（画布 / 来源），区域大于画布时缩小
+    };
+
+    /**
+     * @brief 一张拼好的画布
+     */
+    struct Canvas
+    {
+        cv::Mat image;                      // 画布图像（模型输入尺寸）
+        std::vector<Placement> placements;  // 画布上的区域
+    };
+
+    /**
+     * @brief 拆分回来源的检测结果
+     */
+    struct Detection
+    {
+        size_t tile = 0;            // 区域下标
+        int source = 0;             // 来源编号
+        cv::Rect box;               // 检测框（来源图像坐标系）
+        string name;                // 类别名称
+        float confidence = 0.f;     // 置信度
+    };
+
+    /**
+     * @brief 构造函数
+     *
+     * @param canvasSize 画布尺寸（模型输入尺寸）
+     * @param gap 区域之间及与画布边缘的间隔（像素）
+     * @param fill 画布空白处的填充颜色（默认与 Transformer 的letterbox填充相同）
+     */
+    MosaicPacker(const cv::Size &canvasSize, int gap = 4, const cv::Scalar &fill = cv::Scalar(128));
+
+    /**
+     * @brief 打包区域
+     *
+     * @param tiles 待打包的区域
+     * @return std::vector<Canvas> 画布（一张放不下时依次使用多张）
+     */
+    std::vector<Canvas> pack(const std::vector<Tile> &tiles) const;
+
+    /**
+     * @brief 将一张画布上的检测结果拆分回各来源
+     *
+     * @param canvas 画布
+     * @param tiles 打包时的区域
+     * @param rects 画布坐标系下的检测框
+     * @param names 类别名称
+     * @param confidences 置信度
+     * @param detections 追加拆分后的检测结果
+     */
+    void unpack(const Canvas &canvas,
+                const std::vector<Tile> &tiles,
+                const std::vector<cv::Rect> &rects,
+                const std::vector<string> &names,
+                const std::vector<float> &confidences,
+                std::vector<Detection> &detections) const;
+
+    /**
+     * @brief 画布尺寸
+     */
+    cv::Size getCanvasSize() const;
+
+private:
+    cv::Size canvasSize;            // 画布尺寸
+    int gap;                        // 区域间隔
+    cv::Scalar fill;                // 填充颜色
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include "Include.h"
+
+/**
+ * @brief 基于低分辨率背景模型的变化区域提取
+ *
+ * 画面缩小为低分辨率灰度图，与滑动平均背景逐像素比较，超过阈值的像素膨胀后取外轮廓的外接矩形；
+ * 相邻的矩形合并，数量超过上限时依次合并增加面积最少的一对，最终映射回原图并外扩为适合检测的区域。
+ * 固定机位的画面大部分像素长时间不变，检测只需在少数变化区域上进行。
+ */
+class MotionRegions
+{
+public:
+    /**
+     * @brief 提取参数
+     */
+    struct Options
+    {
+        int width = 160;                // 背景模型宽度（高度按画面宽高比换算）
+        double learningRate = 0.05;     // 背景更新速率
+        double threshold = 25.0;        // 灰度变化阈值
+        int minArea = 4;                // 最小变化面积（背景模型像素）
+        int mergeGap = 2;               // 间距不超过该值（背景模型像素）的区域合并
+        size_t maxRegions = 4;          // 最多区域数
+        float margin = 0.1f;            // 映射回原图后每侧外扩的比例
+        int minSize = 64;               // 映射回原图后的最小边长
+    };
+
+    explicit MotionRegions(const Options &options);
+
+    /**
+     * @brief 用一帧更新背景模型并提取变化区域
+     *
+     * 第一帧（或画面尺寸变化）时只建立背景模型，返回整幅画面
+     *
+     * @param frame 输入图像（BGR）
+     * @return std::vector<cv::Rect> 变化区域（原图坐标系），画面无变化时为空
+     */
+    std::vector<cv::Rect> update(const cv::Mat &frame);
+
+    /**
+     * @brief 上一帧中变化像素的比例
+     */
+    double getChangedRatio() const;
+
+    /**
+     * @brief 合并区域：间距不超过 gap 的区域合并，数量超过 maxRegions 时依次合并增加面积最少的一对
+     *
+     * @param regions 区域
+     * @param gap 合并间距
+     * @param maxRegions 最多区域数，0表示不限
+     */
+    static void merge(std::vector<cv::Rect> &regions, int gap, size_t maxRegions);
+
+private:
+    Options options;                    // 提取参数
+    cv::Mat background;                 // 背景模型（CV_32F灰度）
+    cv::Size frameSize;                 // 建立背景模型时的画面尺寸
+    double changedRatio;                // 变化像素比例
+};
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @brief 基于futex的事件计数器
+ *
+ * 等待方先 prepareWait() 取得当前纪元，再检查条件，条件不满足时 wait()；
+ * 通知方在有等待者时推进纪元并通过futex唤醒。
+ * notifyOne() 只唤醒一个等待者，避免 notify_all 带来的惊群。
+ */
+class EventCount
+{
+public:
+    EventCount() : epoch(0), waiters(0)
+    {
+    }
+
+    /**
+     * @brief 登记为等待者并返回当前纪元
+     *
+     * @return uint32_t 当前纪元，传给 wait()
+     */
+    uint32_t prepareWait()
+    {
+        this->waiters.fetch_add(1, std::memory_order_seq_cst);
+        return this->epoch.load(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief 条件已满足，取消等待登记
+     */
+    void cancelWait()
+    {
+        this->waiters.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief 在纪元未变化时阻塞等待
+     *
+     * @param key prepareWait() 返回的纪元
+     * @param timeoutUs 超时时间（微秒），小于0表示不超时
+     * @return bool 超时返回false
+     */
+    bool wait(uint32_t key, int64_t timeoutUs = -1)
+    {
+        struct timespec ts;
+        struct timespec *timeout = nullptr;
+        if (timeoutUs >= 0)
+        {
+            ts.tv_sec = static_cast<time_t>(timeoutUs / 1000000);
+            ts.tv_nsec = static_cast<long>((timeoutUs % 1000000) * 1000);
+            timeout = &ts;
+        }
+        bool timedOut = false;
+        if (this->epoch.load(std::memory_order_seq_cst) == key)
+        {
+            long ret = syscall(SYS_futex, reinterpret_cast<uint32_t *>(&this->epoch), FUTEX_WAIT_PRIVATE, key, timeout, nullptr, 0);
+            timedOut = ret == -1 && errno == ETIMEDOUT;
+        }
+        this->waiters.fetch_sub(1, std::memory_order_seq_cst);
+        return !timedOut;
+    }
+
+    /**
+     * @brief 唤醒一个等待者
+     */
+    void notifyOne()
+    {
+        this->notify(1);
+    }
+
+    /**
+     * @brief 唤醒所有等待者
+     */
+    void notifyAll()
+    {
+        this->notify(INT_MAX);
+    }
+
+private:
+    void notify(int count)
+    {
+        // 与等待方的 prepareWait() 配对，保证要么看到等待者，要么等待方看到新数据
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->waiters.load(std::memory_order_seq_cst) == 0)
+        {
+            return;
+        }
+        this->epoch.fetch_add(1, std::memory_order_seq_cst);
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&this->epoch), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+    }
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex需要32位原子变量");
+
+    std::atomic<uint32_t> epoch;      // 纪元，futex等待的地址
+    std::atomic<int> waiters;         // 等待者数量
+};
+
+/**
+ * @brief 有界无锁多生产者多消费者环形队列
+ *
+ * 槽位在构造时一次性分配，入队出队只做移动赋值，不再逐次分配内存。
+ * 每个槽位带序号（Vyukov算法），生产者和消费者各自通过CAS推进位置。
+ * 阻塞接口通过两个事件计数器等待"非空"和"非满"，每次只唤醒一个等待者。
+ *
+ * @tparam T 元素类型（需可默认构造和移动赋值）
+ */
+template <typename T>
+class MpmcQueue
+{
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param capacity 队列容量（即背压上限）
+     */
+    explicit MpmcQueue(size_t capacity)
+        : slots(capacity > 0 ? capacity : 1), enqueuePos(0), dequeuePos(0), closed(false)
+    {
+        for (size_t i = 0; i < this->slots.size(); i++)
+        {
+            this->slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue &) = delete;
+    MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+    /**
+     * @brief 非阻塞入队
+     *
+     * @param item 元素，成功时被移走
+     * @return bool 队列已满返回false
+     */
+    bool tryPush(T &item)
+    {
+        size_t pos = this->enqueuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = this->slots[pos % this->slots.size()];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.value = std::move(item);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    this->notEmpty.notifyOne();
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = this->enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief 阻塞入队，队列满时等待
+     *
+     * @param item 元素
+     * @return bool 队列已关闭返回false
+     */
+    bool push(T item)
+    {
+        while (!this->closed.load(std::memory_order_acquire))
+        {
+            if (this->tryPush(item))
+            {
+                return true;
+            }
+            uint32_t key = this->notFull.prepareWait();
+            if (this->closed.load(std::memory_order_acquire))
+            {
+                this->notFull.cancelWait();
+                break;
+            }
+            if (this->tryPush(item))
+            {
+                this->notFull.cancelWait();
+                return true;
+            }
+            this->notFull.wait(key);
+        }
+        return false;
+    }
+
+    /**
+     * @brief 非阻塞出队
+     *
+     * @param item 输出元素
+     * @return bool 队列为空返回false
+     */
+    bool tryPop(T &item)
+    {
+        size_t pos = this->dequeuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = this->slots[pos % this->slots.size()];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (this->dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    item = std::move(slot.value);
+                    slot.value = T();
+                    slot.sequence.store(pos + this->slots.size(), std::memory_order_release);
+                    this->notFull.notifyOne();
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = this->dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief 阻塞出队，队列空时等待
+     *
+     * @param item 输出元素
+     * @return bool 队列已关闭且为空返回false
+     */
+    bool pop(T &item)
+    {
+        return this->popUntil(item, std::chrono::steady_clock::time_point::max());
+    }
+
+    /**
+     * @brief 带截止时间的阻塞出队
+     *
+     * @param item 输出元素
+     * @param deadline 截止时间
+     * @return bool 超时或队列已关闭且为空返回false
+     */
+    bool popUntil(T &item, std::chrono::steady_clock::time_point deadline)
+    {
+        while (true)
+        {
+            if (this->tryPop(item))
+            {
+                return true;
+            }
+            uint32_t key = this->notEmpty.prepareWait();
+            if (this->tryPop(item))
+            {
+                this->notEmpty.cancelWait();
+                return true;
+            }
+            if (this->closed.load(std::memory_order_acquire))
+            {
+                this->notEmpty.cancelWait();
+                return this->tryPop(item);
+            }
+
+            int64_t timeoutUs = -1;
+            if (deadline != std::chrono::steady_clock::time_point::max())
+            {
+                timeoutUs = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now()).count();
+                if (timeoutUs <= 0)
+                {
+                    this->notEmpty.cancelWait();
+                    return false;
+                }
+            }
+            this->notEmpty.wait(key, timeoutUs);
+        }
+    }
+
+    /**
+     * @brief 关闭队列，唤醒所有等待者
+     *
+     * 关闭后不能再入队，消费者取完剩余元素后出队返回false。
+     * 只使用原子操作和futex系统调用，可在信号处理函数中调用。
+     */
+    void close()
+    {
+        this->closed.store(true, std::memory_order_release);
+        this->notEmpty.notifyAll();
+        this->notFull.notifyAll();
+    }
+
+    /**
+     * @brief 队列是否已关闭
+     */
+    bool isClosed() const
+    {
+        return this->closed.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 当前元素数量（并发时为近似值）
+     */
+    size_t size() const
+    {
+        size_t enqueued = this->enqueuePos.load(std::memory_order_acquire);
+        size_t dequeued = this->dequeuePos.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    /**
+     * @brief 队列容量
+     */
+    size_t capacity() const
+    {
+        return this->slots.size();
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;     // 槽位序号
+        T value;                          // 槽位数据
+    };
+
+    // 生产者和消费者位置用填充隔开，避免伪共享（C++14 下 new 不保证 alignas 超对齐）
+    std::vector<Slot> slots;                          // 预分配的槽位
+    char pad0[64];
+    std::atomic<size_t> enqueuePos;                   // 生产者位置
+    char pad1[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> dequeuePos;                   // 消费者位置
+    char pad2[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<bool> closed;                         // 是否已关闭
+    EventCount notEmpty;                              // 非空事件
+    EventCount notFull;                               // 非满事件
+};
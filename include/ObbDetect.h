@@ -0,0 +1,41 @@
+#pragma once
+#include "Detect.h"
+#include "RotatedNms.h"
+
+/**
+ * @brief 旋转目标检测类
+ * 
+ * 该类继承自Detect类，用于YOLOv8-obb类模型的旋转框检测任务，
+ * 适用于俯视、航拍等目标朝向任意的场景。
+ * 模型输出为 [4+C+1, N]：cx, cy, w, h, C个类别置信度, 角度（弧度）。
+ */
+class ObbDetect : public Detect
+{
+public:
+    /**
+     * @brief 默认构造函数
+     */
+    ObbDetect();
+
+    /**
+     * @brief 带参数的构造函数
+     * 
+     * @param dir 模型文件所在目录路径
+     */
+    ObbDetect(string dir);
+
+    using Detect::predict;
+
+    /**
+     * @brief 执行旋转目标检测预测
+     * 
+     * @param images 输入图像列表
+     * @param outputBoxes 输出旋转框列表（原图坐标系，角度单位为度）
+     * @param outputNames 输出类别名称列表
+     * @param outputConfidences 输出置信度列表
+     */
+    void predict(vector<cv::Mat> images,
+                 vector<vector<cv::RotatedRect>> &outputBoxes,
+                 vector<vector<string>> &outputNames,
+                 vector<vector<float>> &outputConfidences);
+};
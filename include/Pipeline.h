@@ -0,0 +1,329 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MpmcQueue.h"
+
+/**
+ * @brief 多级流水线
+ *
+ * 每一级有独立的工作线程数、有界输入队列和最大批量。工作线程从本级队列取出
+ * 一批元素交给处理函数，处理函数返回后将批中的元素依次送入下一级队列；
+ * 下一级队列满时阻塞，形成逐级背压。处理函数可以就地修改、增删批中的元素
+ * （例如需要按序处理的一级可在内部缓存乱序到达的元素）。
+ *
+ * 上游关闭且本级全部线程退出后，自动关闭下一级队列，元素会被逐级排空。
+ *
+ * @tparam T 流水线元素类型（需可默认构造和移动赋值）
+ */
+template <typename T>
+class Pipeline
+{
+public:
+    typedef std::function<void(std::vector<T> &)> Handler;
+    typedef std::function<void(const std::string &)> ThreadInit;
+
+    /**
+     * @brief 单级运行统计
+     */
+    struct StageStats
+    {
+        std::string name;       // 名称
+        int workers;            // 工作线程数
+        size_t queued;          // 队列中的元素数
+        size_t capacity;        // 队列容量
+        uint64_t items;         // 已处理元素数
+        uint64_t batches;       // 已处理批次数
+        double utilization;     // 利用率（处理耗时 / (线程数 * 运行时间)）
+    };
+
+    Pipeline() : started(false)
+    {
+    }
+
+    Pipeline(const Pipeline &) = delete;
+    Pipeline &operator=(const Pipeline &) = delete;
+
+    /**
+     * @brief 析构函数，中止并等待所有工作线程退出
+     */
+    ~Pipeline()
+    {
+        this->abort();
+        this->join();
+    }
+
+    /**
+     * @brief 添加一级（需在 start() 之前调用，按添加顺序串联）
+     *
+     * @param name 名称
+     * @param workers 工作线程数
+     * @param capacity 输入队列容量
+     * @param handler 处理函数
+     * @param maxBatch 每次最多取出的元素数
+     * @param batchWaitUs 取到第一个元素后凑批的最大等待时间（微秒），0表示只取已就绪的元素
+     */
+    void addStage(const std::string &name,
+                  int workers,
+                  size_t capacity,
+                  Handler handler,
+                  size_t maxBatch = 1,
+                  int64_t batchWaitUs = 0)
+    {
+        std::unique_ptr<Stage> stage(new Stage(capacity));
+        stage->name = name;
+        stage->workers = std::max(1, workers);
+        stage->maxBatch.store(std::max<size_t>(1, maxBatch));
+        stage->batchWaitUs.store(batchWaitUs);
+        stage->handler = handler;
+        this->stages.push_back(std::move(stage));
+    }
+
+    /**
+     * @brief 运行中调整某一级的凑批参数（对工作线程下一次取批生效）
+     *
+     * @param name 级名称
+     * @param maxBatch 每次最多取出的元素数
+     * @param batchWaitUs 凑批的最大等待时间（微秒）
+     * @return bool 没有该级返回false
+     */
+    bool setBatching(const std::string &name, size_t maxBatch, int64_t batchWaitUs)
+    {
+        for (const std::unique_ptr<Stage> &stage : this->stages)
+        {
+            if (stage->name == name)
+            {
+                stage->maxBatch.store(std::max<size_t>(1, maxBatch));
+                stage->batchWaitUs.store(std::max<int64_t>(0, batchWaitUs));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 设置工作线程启动时的初始化函数（需在 start() 之前调用）
+     *
+     * @param init 以所在级的名称调用，可用于按级绑定CPU
+     */
+    void setThreadInit(ThreadInit init)
+    {
+        this->threadInit = init;
+    }
+
+    /**
+     * @brief 启动所有工作线程
+     */
+    void start()
+    {
+        this->startTime = std::chrono::steady_clock::now();
+        for (size_t index = 0; index < this->stages.size(); index++)
+        {
+            Stage &stage = *this->stages[index];
+            stage.active.store(stage.workers);
+            for (int w = 0; w < stage.workers; w++)
+            {
+                stage.threads.emplace_back(&Pipeline::run, this, index);
+            }
+        }
+        this->started = true;
+    }
+
+    /**
+     * @brief 向第一级送入元素，队列满时阻塞
+     *
+     * @param item 元素
+     * @return bool 流水线已关闭返回false
+     */
+    bool push(T item)
+    {
+        return this->stages.front()->queue.push(std::move(item));
+    }
+
+    /**
+     * @brief 输入结束，已送入的元素处理完后各级依次退出
+     */
+    void close()
+    {
+        this->stages.front()->queue.close();
+    }
+
+    /**
+     * @brief 立即中止，关闭所有队列（可在信号处理函数中调用）
+     */
+    void abort()
+    {
+        for (const std::unique_ptr<Stage> &stage : this->stages)
+        {
+            stage->queue.close();
+        }
+    }
+
+    /**
+     * @brief 等待所有工作线程退出
+     */
+    void join()
+    {
+        for (const std::unique_ptr<Stage> &stage : this->stages)
+        {
+            for (std::thread &thread : stage->threads)
+            {
+                if (thread.joinable())
+                {
+                    thread.join();
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 获取各级运行统计
+     *
+     * @return std::vector<StageStats> 各级统计
+     */
+    std::vector<StageStats> getStats() const
+    {
+        double elapsedNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                   std::chrono::steady_clock::now() - this->startTime)
+                                                   .count());
+        std::vector<StageStats> stats;
+        for (const std::unique_ptr<Stage> &stage : this->stages)
+        {
+            StageStats stat;
+            stat.name = stage->name;
+            stat.workers = stage->workers;
+            stat.queued = stage->queue.size();
+            stat.capacity = stage->queue.capacity();
+            stat.items = stage->items.load();
+            stat.batches = stage->batches.load();
+            stat.utilization = this->started && elapsedNs > 0
+                                   ? static_cast<double>(stage->busyNs.load()) / (elapsedNs * stage->workers)
+                                   : 0.0;
+            stats.push_back(stat);
+        }
+        return stats;
+    }
+
+    /**
+     * @brief 格式化各级运行统计
+     *
+     * @return std::string 每级一行：名称、线程数、队列占用、处理数、平均批量、利用率
+     */
+    std::string report() const
+    {
+        std::ostringstream out;
+        for (const StageStats &stat : this->getStats())
+        {
+            double averageBatch = stat.batches > 0 ? static_cast<double>(stat.items) / stat.batches : 0.0;
+            out << std::left << std::setw(12) << stat.name
+                << " workers=" << stat.workers
+                << " queue=" << stat.queued << "/" << stat.capacity
+                << " items=" << stat.items
+                << " batch=" << std::fixed << std::setprecision(2) << averageBatch
+                << " util=" << std::setprecision(1) << stat.utilization * 100 << "%"
+                << std::endl;
+        }
+        return out.str();
+    }
+
+private:
+    struct Stage
+    {
+        explicit Stage(size_t capacity)
+            : maxBatch(1), batchWaitUs(0), queue(capacity), active(0), busyNs(0), items(0), batches(0)
+        {
+        }
+
+        std::string name;                   // 名称
+        int workers;                        // 工作线程数
+        std::atomic<size_t> maxBatch;       // 最大批量（运行中可调整）
+        std::atomic<int64_t> batchWaitUs;   // 凑批等待时间（运行中可调整）
+        Handler handler;                    // 处理函数
+        MpmcQueue<T> queue;                 // 输入队列
+        std::vector<std::thread> threads;   // 工作线程
+        std::atomic<int> active;            // 未退出的工作线程数
+        std::atomic<uint64_t> busyNs;       // 累计处理耗时（纳秒）
+        std::atomic<uint64_t> items;        // 累计处理元素数
+        std::atomic<uint64_t> batches;      // 累计处理批次数
+    };
+
+    /**
+     * @brief 工作线程主循环
+     *
+     * @param index 所在级的下标
+     */
+    void run(size_t index)
+    {
+        Stage &stage = *this->stages[index];
+        Stage *next = index + 1 < this->stages.size() ? this->stages[index + 1].get() : nullptr;
+        if (this->threadInit)
+        {
+            this->threadInit(stage.name);
+        }
+
+        std::vector<T> batch;
+        batch.reserve(stage.maxBatch.load());
+        T item;
+        while (stage.queue.pop(item))
+        {
+            batch.clear();
+            batch.push_back(std::move(item));
+            size_t maxBatch = stage.maxBatch.load();
+            int64_t batchWaitUs = stage.batchWaitUs.load();
+            if (batchWaitUs > 0)
+            {
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(batchWaitUs);
+                while (batch.size() < maxBatch && stage.queue.popUntil(item, deadline))
+                {
+                    batch.push_back(std::move(item));
+                }
+            }
+            else
+            {
+                while (batch.size() < maxBatch && stage.queue.tryPop(item))
+                {
+                    batch.push_back(std::move(item));
+                }
+            }
+
+            size_t count = batch.size();
+            auto begin = std::chrono::steady_clock::now();
+            stage.handler(batch);
+            auto busy = std::chrono::steady_clock::now() - begin;
+            stage.busyNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count());
+            stage.items.fetch_add(count);
+            stage.batches.fetch_add(1);
+
+            if (next != nullptr)
+            {
+                for (T &output : batch)
+                {
+                    if (!next->queue.push(std::move(output)))
+                    {
+                        break;
+                    }
+                }
+            }
+            // 及时释放元素持有的资源（如帧缓冲引用）
+            batch.clear();
+        }
+
+        // 本级最后一个退出的线程关闭下一级，使其排空后退出
+        if (stage.active.fetch_sub(1) == 1 && next != nullptr)
+        {
+            next->queue.close();
+        }
+    }
+
+    std::vector<std::unique_ptr<Stage>> stages;                 // 各级
+    ThreadInit threadInit;                                      // 工作线程初始化函数
+    std::chrono::steady_clock::time_point startTime;            // 启动时间
+    bool started;                                               // 是否已启动
+};
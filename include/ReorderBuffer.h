@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "MpmcQueue.h"
+
+/**
+ * @brief 按序号重排缓冲
+ *
+ * 乱序完成的元素按序号放入大小为 window 的预分配环形槽位，
+ * 下一个序号一旦就绪立即按序取出，不必等待后面的元素。
+ * 生产者在分配序号前调用 waitForSlot()，保证在途序号不超出窗口，
+ * 因此 insert() 永不阻塞，可在流水线的工作线程中安全调用。
+ *
+ * @tparam T 元素类型（需可默认构造和移动赋值）
+ */
+template <typename T>
+class ReorderBuffer
+{
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param window 窗口大小（最多同时在途的序号数）
+     */
+    explicit ReorderBuffer(size_t window)
+        : slots(window > 0 ? window : 1), ready(slots.size(), 0), nextSequence(0), closed(false)
+    {
+    }
+
+    ReorderBuffer(const ReorderBuffer &) = delete;
+    ReorderBuffer &operator=(const ReorderBuffer &) = delete;
+
+    /**
+     * @brief 等待序号进入窗口
+     *
+     * @param sequence 即将分配的序号
+     * @return bool 缓冲已关闭返回false
+     */
+    bool waitForSlot(int64_t sequence)
+    {
+        while (true)
+        {
+            uint32_t key = this->slotEvent.prepareWait();
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if (sequence < this->nextSequence + static_cast<int64_t>(this->slots.size()))
+                {
+                    this->slotEvent.cancelWait();
+                    return true;
+                }
+            }
+            if (this->closed.load(std::memory_order_acquire))
+            {
+                this->slotEvent.cancelWait();
+                return false;
+            }
+            this->slotEvent.wait(key);
+        }
+    }
+
+    /**
+     * @brief 放入已完成的元素（序号需已通过 waitForSlot()）
+     *
+     * @param sequence 序号
+     * @param item 元素
+     */
+    void insert(int64_t sequence, T item)
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            size_t index = static_cast<size_t>(sequence % static_cast<int64_t>(this->slots.size()));
+            this->slots[index] = std::move(item);
+            this->ready[index] = 1;
+        }
+        this->readyEvent.notifyOne();
+    }
+
+    /**
+     * @brief 非阻塞取出下一个序号的元素
+     *
+     * @param item 输出元素
+     * @return bool 下一个序号尚未就绪返回false
+     */
+    bool tryPop(T &item)
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            size_t index = static_cast<size_t>(this->nextSequence % static_cast<int64_t>(this->slots.size()));
+            if (!this->ready[index])
+            {
+                return false;
+            }
+            item = std::move(this->slots[index]);
+            this->slots[index] = T();
+            this->ready[index] = 0;
+            this->nextSequence++;
+        }
+        this->slotEvent.notifyAll();
+        return true;
+    }
+
+    /**
+     * @brief 阻塞取出下一个序号的元素
+     *
+     * @param item 输出元素
+     * @return bool 已关闭且下一个序号未就绪返回false
+     */
+    bool pop(T &item)
+    {
+        while (true)
+        {
+            uint32_t key = this->readyEvent.prepareWait();
+            if (this->tryPop(item))
+            {
+                this->readyEvent.cancelWait();
+                return true;
+            }
+            if (this->closed.load(std::memory_order_acquire))
+            {
+                this->readyEvent.cancelWait();
+                return false;
+            }
+            this->readyEvent.wait(key);
+        }
+    }
+
+    /**
+     * @brief 关闭缓冲，唤醒所有等待者（可在信号处理函数中调用）
+     *
+     * 关闭后 pop() 仍会取出已按序就绪的元素。
+     */
+    void close()
+    {
+        this->closed.store(true, std::memory_order_release);
+        this->readyEvent.notifyAll();
+        this->slotEvent.notifyAll();
+    }
+
+    /**
+     * @brief 窗口大小
+     */
+    size_t window() const
+    {
+        return this->slots.size();
+    }
+
+private:
+    std::vector<T> slots;            // 预分配的环形槽位
+    std::vector<char> ready;         // 槽位是否已就绪
+    int64_t nextSequence;            // 下一个待取出的序号
+    std::atomic<bool> closed;        // 是否已关闭
+    std::mutex mutex;                // 保护槽位和序号
+    EventCount readyEvent;           // 下一个序号就绪事件
+    EventCount slotEvent;            // 窗口前移事件
+};
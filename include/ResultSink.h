@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+#include "Include.h"
+#include "STrack.h"
+
+/**
+ * @brief 结果输出格式
+ */
+enum SinkFormat
+{
+    SINK_BINARY = 0,    // 带长度前缀的二进制记录
+    SINK_JSONL = 1      // 每帧一行JSON
+};
+
+/**
+ * @brief 解析结果输出格式名称
+ *
+ * @param name binary / jsonl
+ * @return SinkFormat 输出格式，无法识别时为二进制
+ */
+inline SinkFormat parseSinkFormat(const string &name)
+{
+    return name == "jsonl" ? SINK_JSONL : SINK_BINARY;
+}
+
+/**
+ * @brief 逐帧检测结果输出
+ *
+ * 无界面运行时代替绘制和显示，将每帧的检测框和跟踪结果写入文件或命名管道。
+ * 多个线程可并发写入，每条记录整体写出，不会交错。
+ *
+ * 二进制记录（本机字节序）：
+ *   uint32 payload长度，随后为payload：
+ *   int32 视频流序号, int64 帧序号, uint32 检测数, uint32 跟踪数,
+ *   检测数 x {int32 类别ID, float 置信度, float x, y, w, h},
+ *   跟踪数 x {int32 跟踪ID, float 置信度, float x, y, w, h}
+ *
+ * JSONL记录：
+ *   {"stream":0,"frame":0,"detections":[{"class":0,"name":"person","conf":0.9,"box":[x,y,w,h]}],
+ *    "tracks":[{"id":1,"conf":0.9,"box":[x,y,w,h]}]}
+ */
+class ResultSink
+{
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param path 输出文件路径
+     * @param format 输出格式
+     * @param classNames 类别名称，下标即类别ID
+     * @param fifo 是否以命名管道输出（不存在时创建，打开时阻塞直到有读者）
+     */
+    ResultSink(const string &path, SinkFormat format, const vector<string> &classNames, bool fifo = false);
+
+    ResultSink(const ResultSink &) = delete;
+    ResultSink &operator=(const ResultSink &) = delete;
+
+    /**
+     * @brief 析构函数，刷新并关闭输出
+     */
+    ~ResultSink();
+
+    /**
+     * @brief 输出是否已打开
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief 写入一帧的结果
+     *
+     * @param stream 视频流序号
+     * @param sequence 帧序号
+     * @param rects 检测框
+     * @param names 类别名称
+     * @param confidences 置信度
+     * @param tracks 跟踪结果（未启用跟踪时为空）
+     * @return bool 写入失败（如管道读端已关闭）返回false
+     */
+    bool write(int stream,
+               int64_t sequence,
+               const vector<cv::Rect> &rects,
+               const vector<string> &names,
+               const vector<float> &confidences,
+               const vector<STrack> &tracks);
+
+    /**
+     * @brief 刷新并关闭输出
+     */
+    void close();
+
+    /**
+     * @brief 已写入的记录数
+     */
+    uint64_t getWritten() const;
+
+private:
+    /**
+     * @brief 编码二进制记录
+     */
+    void encodeBinary(int stream,
+                      int64_t sequence,
+                      const vector<cv::Rect> &rects,
+                      const vector<string> &names,
+                      const vector<float> &confidences,
+                      const vector<STrack> &tracks,
+                      string &record);
+
+    /**
+     * @brief 编码JSONL记录
+     */
+    void encodeJson(int stream,
+                    int64_t sequence,
+                    const vector<cv::Rect> &rects,
+                    const vector<string> &names,
+                    const vector<float> &confidences,
+                    const vector<STrack> &tracks,
+                    string &record);
+
+    /**
+     * @brief 类别名称对应的类别ID，未知类别为-1
+     */
+    int classId(const string &name) const;
+
+    SinkFormat format;                          // 输出格式
+    bool fifo;                                  // 是否为命名管道（每条记录后刷新）
+    FILE *file;                                 // 输出文件
+    std::mutex mutex;                           // 保证记录整体写出
+    unordered_map<string, int> classIds;        // 类别名称到类别ID
+    std::atomic<uint64_t> written;              // 已写入的记录数
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include "Include.h"
+
+/**
+ * @brief 计算两个旋转框的交并比
+ * 
+ * 先做外接矩形的快速排除，再用多边形裁剪求精确交集面积。
+ * 
+ * @param a 第一个旋转框
+ * @param b 第二个旋转框
+ * @return float 交并比
+ */
+float rotatedIou(const cv::RotatedRect &a, const cv::RotatedRect &b);
+
+/**
+ * @brief 按类别进行旋转框非极大值抑制
+ * 
+ * 每个框的顶点、外接矩形和面积只计算一次；候选对先用外接矩形是否相交排除，
+ * 再用外接矩形交集给出的交并比上界排除，只有剩下的框对才做多边形裁剪。
+ * 
+ * @param boxes 旋转框列表
+ * @param scores 置信度列表
+ * @param classIds 类别索引列表（不同类别之间不互相抑制）
+ * @param scoreThreshold 置信度阈值
+ * @param nmsThreshold 交并比阈值
+ * @param indexes 输出保留下来的框索引（按置信度从高到低）
+ */
+void rotatedNmsBoxesBatched(const vector<cv::RotatedRect> &boxes,
+                            const vector<float> &scores,
+                            const vector<int> &classIds,
+                            float scoreThreshold,
+                            float nmsThreshold,
+                            vector<int> &indexes);
@@ -50,8 +50,9 @@ public:
 	 * 
 	 * @param stracks 轨迹指针列表
 	 * @param kalman_filter 卡尔曼滤波器实例
+	 * @param dt 时间间隔（以帧为单位）
 	 */
-	void static multi_predict( std::vector<STrack*> &stracks, byte_kalman::ByteKalmanFilter &kalman_filter);
+	void static multi_predict( std::vector<STrack*> &stracks, byte_kalman::ByteKalmanFilter &kalman_filter, float dt = 1.f);
 	
 	/**
 	 * @brief 计算tlwh坐标
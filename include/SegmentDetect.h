@@ -0,0 +1,68 @@
+#pragma once
+#include <set>
+#include "Detect.h"
+
+/**
+ * @brief 实例分割类
+ * 
+ * 该类继承自Detect类，用于YOLOv8-seg类模型的实例分割任务。
+ * 模型输出为 [4+C+M, N] 的检测结果（每个候选框带M个掩码系数）
+ * 以及 [M, H, W] 的原型掩码。掩码只对NMS之后保留、且属于指定类别的
+ * 检测框计算，并且只在框内的原型区域上计算和放大。
+ */
+class SegmentDetect : public Detect
+{
+protected:
+    int maskDim;                             // 掩码系数数量
+    int protoHeight;                         // 原型掩码高度
+    int protoWidth;                          // 原型掩码宽度
+    std::set<string> maskClasses;            // 需要计算掩码的类别（为空表示全部）
+
+public:
+    /**
+     * @brief 默认构造函数
+     */
+    SegmentDetect();
+
+    /**
+     * @brief 带参数的构造函数
+     * 
+     * @param dir 模型文件所在目录路径
+     */
+    SegmentDetect(string dir);
+
+    using Detect::predict;
+
+    /**
+     * @brief 执行实例分割预测
+     * 
+     * @param images 输入图像列表
+     * @param outputRects 输出检测框列表
+     * @param outputNames 输出类别名称列表
+     * @param outputConfidences 输出置信度列表
+     * @param outputMasks 输出掩码列表，每个掩码为与检测框同尺寸的 CV_8UC1 图像，
+     *                    不需要掩码的类别为空矩阵
+     */
+    void predict(vector<cv::Mat> images,
+                 vector<vector<cv::Rect>> &outputRects,
+                 vector<vector<string>> &outputNames,
+                 vector<vector<float>> &outputConfidences,
+                 vector<vector<cv::Mat>> &outputMasks);
+
+protected:
+    /**
+     * @brief 计算单个检测框的掩码
+     * 
+     * @param protos 原型掩码 [M, H*W]
+     * @param coeffs 掩码系数 [1, M]
+     * @param box 检测框（模型输入坐标系）
+     * @param outputBox 检测框（原图坐标系）
+     * @param transformer 图像变换器
+     * @return cv::Mat 与 outputBox 同尺寸的 CV_8UC1 掩码
+     */
+    cv::Mat buildMask(const cv::Mat &protos,
+                      const cv::Mat &coeffs,
+                      const cv::Rect &box,
+                      const cv::Rect &outputBox,
+                      Transformer &transformer);
+};
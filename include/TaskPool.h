@@ -0,0 +1,119 @@
+#pragma once
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MpmcQueue.h"
+
+/**
+ * @brief 工作窃取线程池
+ *
+ * 每个工作线程有自己的双端任务队列：本线程从队尾取（后进先出，缓存友好），
+ * 空闲线程从其它线程的队头窃取（先进先出，取走最早提交的大块任务）。
+ * 池内线程提交的任务进入自己的队列，外部线程提交的任务轮流分配到各队列。
+ * 各CPU级共享同一个池，某一路的帧较重时负载自动分摊到空闲核心。
+ */
+class TaskPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    /**
+     * @brief 构造函数
+     *
+     * @param workerNum 工作线程数
+     * @param cpus 工作线程绑定的CPU编号，为空表示不绑定
+     */
+    explicit TaskPool(int workerNum, const std::vector<int> &cpus = std::vector<int>());
+
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+
+    /**
+     * @brief 析构函数，执行完已提交的任务后退出所有工作线程
+     */
+    ~TaskPool();
+
+    /**
+     * @brief 提交任务
+     *
+     * @param task 任务
+     */
+    void submit(Task task);
+
+    /**
+     * @brief 并行执行 body(0) ... body(count - 1) 并等待全部完成
+     *
+     * 调用线程执行第一个下标，等待期间帮助执行池中的任务，因此可以嵌套调用。
+     * 任一下标抛出的第一个异常在全部完成后重新抛出。
+     *
+     * @param count 下标数量
+     * @param body 处理函数
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)> &body);
+
+    /**
+     * @brief 工作线程数
+     */
+    int getWorkerNum() const;
+
+    /**
+     * @brief 已执行的任务数
+     */
+    uint64_t getExecuted() const;
+
+    /**
+     * @brief 被其它线程窃取执行的任务数
+     */
+    uint64_t getStolen() const;
+
+    /**
+     * @brief 格式化运行统计
+     *
+     * @return std::string 线程数、已执行任务数和窃取比例
+     */
+    std::string report() const;
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;           // 保护任务队列
+        std::deque<Task> tasks;     // 任务队列
+        std::thread thread;         // 工作线程
+    };
+
+    /**
+     * @brief 工作线程主循环
+     *
+     * @param index 工作线程下标
+     */
+    void run(int index);
+
+    /**
+     * @brief 取出并执行一个任务：先取自己的队尾，再窃取其它队列的队头
+     *
+     * @param self 调用线程的下标，-1表示池外线程
+     * @return bool 没有可执行的任务返回false
+     */
+    bool runOne(int self);
+
+    /**
+     * @brief 调用线程在本池中的下标
+     *
+     * @return int 池外线程返回-1
+     */
+    int currentIndex() const;
+
+    std::vector<std::unique_ptr<Worker>> workers;   // 工作线程及其任务队列
+    std::vector<int> cpus;                          // 绑定的CPU编号
+    std::atomic<int64_t> pending;                   // 已提交未取出的任务数
+    std::atomic<bool> stopping;                     // 是否正在退出
+    std::atomic<size_t> nextWorker;                 // 外部提交时的轮转位置
+    std::atomic<uint64_t> executed;                 // 已执行任务数
+    std::atomic<uint64_t> stolen;                   // 窃取执行的任务数
+    EventCount event;                               // 有新任务或退出
+};
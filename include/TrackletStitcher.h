@@ -0,0 +1,110 @@
+#pragma once
+#include <map>
+#include "Include.h"
+
+/**
+ * @brief 一帧中的一条跟踪结果
+ */
+struct TrackRecord
+{
+    int64_t frame = 0;              // 帧序号（按时间戳和帧率换算，各分段一致）
+    int id = 0;                     // 轨迹ID（分段内ID或拼接后的全局ID）
+    cv::Rect_<float> box;           // 跟踪框
+    float score = 0.f;              // 检测置信度
+};
+
+/**
+ * @brief 分段跟踪的轨迹拼接
+ *
+ * 视频按关键帧切成相互重叠的分段并行跟踪后，相邻分段在重叠窗口内对同一批帧各有一份轨迹。
+ * 前一分段的轨迹与后一分段的轨迹按重叠窗口内同帧框的平均IoU匹配（共同帧数不少于下限），
+ * 没有共同帧的轨迹再按时间连续性匹配（前者结束与后者开始间隔不超过若干帧且首尾框IoU达标），
+ * 匹配上的轨迹沿用前一分段的全局ID，其余轨迹分配新的全局ID。
+ * 每一帧只输出一个分段的结果：交接帧之前取前一分段，从交接帧起取后一分段。
+ */
+class TrackletStitcher
+{
+public:
+    /**
+     * @brief 拼接参数
+     */
+    struct Options
+    {
+        float iou = 0.5f;           // 匹配所需的平均IoU
+        int minFrames = 3;          // 按重叠匹配所需的共同帧数
+        int maxGap = 5;             // 按时间连续性匹配允许的间隔帧数
+    };
+
+    /**
+     * @brief 相邻分段之间的交接
+     */
+    struct Handover
+    {
+        int64_t overlapBegin = 0;   // 重叠窗口起始帧（后一分段的第一帧）
+        int64_t frame = 0;          // 交接帧（重叠窗口结束帧，之前的帧由前一分段输出）
+    };
+
+    explicit TrackletStitcher(const Options &options);
+
+    /**
+     * @brief 拼接各分段的跟踪结果
+     *
+     * @param segments 各分段的跟踪结果（分段内轨迹ID，按时间顺序排列）
+     * @param handovers 相邻分段之间的交接（数量为分段数减一）
+     * @return std::vector<TrackRecord> 使用全局ID的跟踪结果，按帧序号排列
+     */
+    std::vector<TrackRecord> stitch(const std::vector<std::vector<TrackRecord>> &segments,
+                                    const std::vector<Handover> &handovers);
+
+    /**
+     * @brief 上次拼接中按重叠窗口匹配的轨迹数
+     */
+    int getOverlapLinks() const;
+
+    /**
+     * @brief 上次拼接中按时间连续性匹配的轨迹数
+     */
+    int getGapLinks() const;
+
+    /**
+     * @brief 上次拼接得到的全局轨迹数
+     */
+    int getGlobalTracks() const;
+
+private:
+    /**
+     * @brief 分段内的一条轨迹
+     */
+    struct Tracklet
+    {
+        int id = 0;                                     // 分段内ID
+        std::map<int64_t, cv::Rect_<float>> boxes;      // 帧序号 -> 跟踪框
+    };
+
+    /**
+     * @brief 将分段结果按轨迹ID分组
+     */
+    static std::vector<Tracklet> group(const std::vector<TrackRecord> &records);
+
+    /**
+     * @brief 两个框的IoU
+     */
+    static float iou(const cv::Rect_<float> &a, const cv::Rect_<float> &b);
+
+    /**
+     * @brief 匹配相邻两个分段的轨迹
+     *
+     * @param previous 前一分段的轨迹
+     * @param next 后一分段的轨迹
+     * @param handover 交接
+     * @return std::map<int, int> 后一分段ID -> 前一分段ID
+     */
+    std::map<int, int> match(const std::vector<Tracklet> &previous,
+                             const std::vector<Tracklet> &next,
+                             const Handover &handover);
+
+    Options options;                // 拼接参数
+    int overlapLinks;               // 按重叠窗口匹配的轨迹数
+    int gapLinks;                   // 按时间连续性匹配的轨迹数
+    int globalTracks;               // 全局轨迹数
+};
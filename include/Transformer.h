@@ -14,6 +14,7 @@ protected:
     cv::Mat oriImage;           // 原始图像
     cv::Mat normalizeImage;     // 归一化后的图像
     cv::Mat inputMat;           // 输入到模型的图像矩阵
+    cv::Size sourceSize;        // 解码前的原始尺寸（图像已在解码时缩放时设置）
 
     int normalizeHeight;        // 归一化图像高度
     int normalizeWidth;         // 归一化图像宽度
@@ -49,6 +50,18 @@ public:
      */
     Transformer(cv::Mat image, int normalizeHeight, int normalizeWidth);
 
+    /**
+     * @brief 构造函数，使用解码时已按letterbox比例缩放的图像
+     * 
+     * 坐标反变换回 sourceSize 坐标系；图像尺寸与等比缩放尺寸一致时跳过缩放
+     * 
+     * @param image 已缩放的输入图像
+     * @param normalizeHeight 目标归一化高度
+     * @param normalizeWidth 目标归一化宽度
+     * @param sourceSize 缩放前的原始尺寸
+     */
+    Transformer(cv::Mat image, int normalizeHeight, int normalizeWidth, cv::Size sourceSize);
+
     /**
      * @brief 图像预处理
      * 
@@ -67,6 +80,15 @@ public:
     virtual void reverse(std::vector<cv::Rect> &boxes,
                          std::vector<std::vector<cv::Point>> &points);
 
+    /**
+     * @brief 旋转框坐标反变换
+     * 
+     * 将模型输出的旋转框变换回原始图像坐标系（中心点和尺寸缩放，角度不变）
+     * 
+     * @param boxes 旋转框
+     */
+    void reverse(std::vector<cv::RotatedRect> &boxes);
+
     /**
      * @brief 获取归一化图像
      * 
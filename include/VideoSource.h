@@ -0,0 +1,182 @@
+#pragma once
+#include <atomic>
+#include "Include.h"
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVFrame;
+struct AVPacket;
+struct SwsContext;
+
+/**
+ * @brief 解码时跳过的帧
+ */
+enum DecodeSkip
+{
+    DECODE_ALL = 0,            // 解码全部帧
+    DECODE_SKIP_NONREF = 1,    // 跳过非参考帧（H.264/H.265中通常为B帧）
+    DECODE_KEYFRAMES = 2       // 只解码关键帧（非关键帧的包不送入解码器）
+};
+
+/**
+ * @brief 解析解码跳帧方式名称
+ *
+ * @param name all / nonref / keyframes
+ * @return DecodeSkip 跳帧方式，无法识别时解码全部帧
+ */
+inline DecodeSkip parseDecodeSkip(const string &name)
+{
+    if (name == "nonref")
+    {
+        return DECODE_SKIP_NONREF;
+    }
+    if (name == "keyframes")
+    {
+        return DECODE_KEYFRAMES;
+    }
+    return DECODE_ALL;
+}
+
+/**
+ * @brief 按letterbox规则计算等比缩放后的尺寸（与 Transformer::process 一致）
+ *
+ * @param source 原始尺寸
+ * @param target letterbox目标尺寸（模型输入尺寸）
+ * @return cv::Size 缩放后、填充前的尺寸
+ */
+cv::Size letterboxSize(const cv::Size &source, const cv::Size &target);
+
+/**
+ * @brief 基于FFmpeg的视频源
+ *
+ * 使用libavformat解复用、libavcodec帧级+片级多线程解码，
+ * 并通过sws_scale在一次转换中完成缩放和像素格式转换（BGR24），
+ * 直接写入调用方提供的缓冲（如帧池槽位），避免先解出全分辨率图像再缩放。
+ */
+class VideoSource
+{
+public:
+    /**
+     * @brief 打开选项
+     */
+    struct Options
+    {
+        int threads = 0;                    // 解码线程数，0表示由FFmpeg按CPU数决定
+        DecodeSkip skip = DECODE_ALL;       // 跳帧方式
+        cv::Size outputSize;                // 输出尺寸，为空表示原始尺寸
+    };
+
+    VideoSource();
+
+    VideoSource(const VideoSource &) = delete;
+    VideoSource &operator=(const VideoSource &) = delete;
+
+    /**
+     * @brief 析构函数，释放FFmpeg资源
+     */
+    ~VideoSource();
+
+    /**
+     * @brief 打开视频文件或网络流
+     *
+     * @param path 视频路径或URL
+     * @param options 打开选项
+     * @return bool 打开失败返回false
+     */
+    bool open(const string &path, const Options &options);
+
+    /**
+     * @brief 是否已打开
+     */
+    bool isOpened() const;
+
+    /**
+     * @brief 读取下一帧
+     *
+     * frame 的尺寸和类型与输出一致（CV_8UC3）时直接写入其缓冲，否则重新分配。
+     *
+     * @param frame 输出图像（BGR）
+     * @return bool 视频结束或出错返回false
+     */
+    bool read(cv::Mat &frame);
+
+    /**
+     * @brief 定位到指定时间之前（含）最近的关键帧，之后的读取从该关键帧开始解码
+     *
+     * @param seconds 时间（秒）
+     * @return bool 定位失败返回false
+     */
+    bool seek(double seconds);
+
+    /**
+     * @brief 只解复用不解码，扫描视频流中关键帧的时间戳
+     *
+     * @param path 视频路径
+     * @param keyframes 关键帧时间戳（秒，升序）
+     * @param duration 最后一个视频包的结束时间（秒）
+     * @return bool 打开失败或没有视频流返回false
+     */
+    static bool probeKeyframes(const string &path, std::vector<double> &keyframes, double &duration);
+
+    /**
+     * @brief 修改输出尺寸（在打开之后、读取之前按原始尺寸确定输出尺寸时使用）
+     *
+     * @param size 输出尺寸，为空表示原始尺寸
+     */
+    void setOutputSize(const cv::Size &size);
+
+    /**
+     * @brief 释放资源
+     */
+    void release();
+
+    /**
+     * @brief 帧率
+     */
+    double getFps() const;
+
+    /**
+     * @brief 最近一次读取的帧的时间戳（秒）
+     *
+     * 取解码器给出的最佳时间戳，缺失时按帧率和已输出帧数推算
+     */
+    double getTimestamp() const;
+
+    /**
+     * @brief 原始尺寸
+     */
+    cv::Size getSourceSize() const;
+
+    /**
+     * @brief 输出尺寸
+     */
+    cv::Size getOutputSize() const;
+
+    /**
+     * @brief 已输出的帧数
+     */
+    uint64_t getDecoded() const;
+
+private:
+    /**
+     * @brief 从解码器取出下一帧，需要时继续读包送入解码器
+     *
+     * @return bool 视频结束或出错返回false
+     */
+    bool decodeNext();
+
+    AVFormatContext *format;        // 解复用上下文
+    AVCodecContext *codec;          // 解码上下文
+    SwsContext *sws;                // 缩放和像素格式转换上下文
+    AVFrame *frame;                 // 解码输出
+    AVPacket *packet;               // 读取的包
+    int streamIndex;                // 视频流下标
+    bool draining;                  // 是否已送入结束标记
+    DecodeSkip skip;                // 跳帧方式
+    double fps;                     // 帧率
+    double timeBase;                // 视频流时间基（秒）
+    double timestamp;               // 最近一次读取的帧的时间戳（秒）
+    cv::Size sourceSize;            // 原始尺寸
+    cv::Size outputSize;            // 输出尺寸
+    std::atomic<uint64_t> decoded;  // 已输出的帧数
+};
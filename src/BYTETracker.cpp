@@ -504,7 +504,7 @@ double BYTETracker::lapjv(const  std::vector< std::vector<float> > &cost,  std::
 // brief 更新跟踪器状态
 // param objects 检测结果
 // return 当前帧的跟踪结果
-std::vector<STrack> BYTETracker::update(const std::vector<detect_result>& objects)
+std::vector<STrack> BYTETracker::update(const std::vector<detect_result>& objects, float dt)
 {
 	//////////// Step 1: Get detections ////////////
 	// 增加帧ID计数
@@ -570,7 +570,7 @@ std::vector<STrack> BYTETracker::update(const std::vector<detect_result>& object
 	// 合并跟踪中的轨迹和丢失的轨迹形成轨迹池
 	strack_pool = joint_stracks(tracked_stracks, this->lost_stracks);
 	// 对轨迹池中的所有轨迹进行预测
-	STrack::multi_predict(strack_pool, this->kalman_filter);
+	STrack::multi_predict(strack_pool, this->kalman_filter, dt);
 
 	// 计算轨迹池与高置信度检测之间的IOU距离
 	std::vector<std::vector<float> > dists;
@@ -757,4 +757,93 @@ std::vector<STrack> BYTETracker::update(const std::vector<detect_result>& object
 		}
 	}
 	return output_stracks;
-}
\ No newline at end of file
+}
+
+// brief 无检测结果的帧：只按运动模型预测轨迹位置
+// param dt 距上一帧的时间间隔（以帧为单位）
+// return 当前帧的跟踪结果（预测位置）
+std::vector<STrack> BYTETracker::predict(float dt)
+{
+	// 帧ID照常递增，丢失轨迹的保留时间按帧计算
+	this->frame_id++;
+
+	// 与 update 相同：预测已确认的跟踪轨迹和丢失的轨迹，待确认的轨迹留到下一次检测时匹配
+	std::vector<STrack*> strack_pool;
+	for (int i = 0; i < this->tracked_stracks.size(); i++)
+	{
+		if (this->tracked_stracks[i].is_activated)
+			strack_pool.push_back(&this->tracked_stracks[i]);
+	}
+	for (int i = 0; i < this->lost_stracks.size(); i++)
+	{
+		strack_pool.push_back(&this->lost_stracks[i]);
+	}
+	STrack::multi_predict(strack_pool, this->kalman_filter, dt);
+
+	std::vector<STrack> output_stracks;
+	for (int i = 0; i < this->tracked_stracks.size(); i++)
+	{
+		STrack &track = this->tracked_stracks[i];
+		if (track.is_activated)
+		{
+			track.static_tlwh();
+			track.static_tlbr();
+			output_stracks.push_back(track);
+		}
+	}
+	return output_stracks;
+}
+
+// brief 预测已确认轨迹在下一帧的位置（不修改跟踪状态）
+// param dt 距上一帧的时间间隔（以帧为单位）
+// return 预测框
+std::vector<cv::Rect_<float>> BYTETracker::predict_boxes(float dt) const
+{
+	// 在副本上预测，下一次 update 仍从当前状态出发
+	byte_kalman::ByteKalmanFilter filter = this->kalman_filter;
+	std::vector<cv::Rect_<float>> boxes;
+	for (int i = 0; i < this->tracked_stracks.size(); i++)
+	{
+		if (!this->tracked_stracks[i].is_activated)
+			continue;
+		STrack track = this->tracked_stracks[i];
+		filter.predict(track.mean, track.covariance, dt);
+		track.static_tlwh();
+		boxes.push_back(cv::Rect_<float>(track.tlwh[0], track.tlwh[1], track.tlwh[2], track.tlwh[3]));
+	}
+	return boxes;
+}
+
+// brief 已确认轨迹的最大位置不确定度
+// return 中心点位置标准差与框高之比的最大值
+float BYTETracker::max_uncertainty() const
+{
+	float result = 0;
+	for (int i = 0; i < this->tracked_stracks.size(); i++)
+	{
+		const STrack &track = this->tracked_stracks[i];
+		if (!track.is_activated || track.mean(3) <= 0)
+			continue;
+		float std = std::sqrt(track.covariance(0, 0) + track.covariance(1, 1));
+		result = std::max(result, std / track.mean(3));
+	}
+	return result;
+}
+
+// brief 待确认的新轨迹数
+int BYTETracker::unconfirmed_count() const
+{
+	int count = 0;
+	for (int i = 0; i < this->tracked_stracks.size(); i++)
+	{
+		if (!this->tracked_stracks[i].is_activated)
+			count++;
+	}
+	return count;
+}
+
+// brief 丢失中的轨迹数
+int BYTETracker::lost_count() const
+{
+	return static_cast<int>(this->lost_stracks.size());
+}
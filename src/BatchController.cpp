@@ -0,0 +1,250 @@
+#include "BatchController.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+const double EWMA_ALPHA = 0.2;              // 推理耗时滑动平均系数
+const uint64_t MIN_SAMPLES = 3;             // 直接采用某批量滑动平均的最少样本数
+const size_t MAX_LATENCY_SAMPLES = 4096;    // 每周期保留的延迟样本数
+const double CAPACITY_HEADROOM = 1.1;       // 推理吞吐需超出到达帧率的比例
+const double LATENCY_MARGIN = 0.9;          // 预计延迟需低于目标的比例
+}
+
+BatchController::BatchController(const Options &options, size_t initialBatch, int64_t initialWaitUs, Apply apply)
+    : options(options), apply(apply), latencySeen(0), lastTune(Clock::now()), arrivals(0)
+{
+    this->options.maxBatch = std::max<size_t>(1, options.maxBatch);
+    this->options.workers = std::max(1, options.workers);
+    this->times.resize(this->options.maxBatch + 1);
+    this->latencies.reserve(MAX_LATENCY_SAMPLES);
+    this->decision.batch = std::min(std::max<size_t>(1, initialBatch), this->options.maxBatch);
+    this->decision.waitUs = initialWaitUs;
+    this->decision.reason = "initial";
+}
+
+void BatchController::recordArrival(size_t count)
+{
+    this->arrivals.fetch_add(count);
+}
+
+void BatchController::recordBatch(size_t batch, int64_t inferUs)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (batch >= 1 && batch < this->times.size())
+    {
+        BatchTime &time = this->times[batch];
+        time.ewmaUs = time.count == 0 ? inferUs : (1.0 - EWMA_ALPHA) * time.ewmaUs + EWMA_ALPHA * inferUs;
+        time.count++;
+    }
+    Clock::time_point now = Clock::now();
+    double seconds = std::chrono::duration<double>(now - this->lastTune).count();
+    if (seconds * 1000.0 >= this->options.intervalMs)
+    {
+        this->lastTune = now;
+        this->tune(seconds);
+    }
+}
+
+void BatchController::recordLatency(int64_t latencyUs)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->latencies.size() < MAX_LATENCY_SAMPLES)
+    {
+        this->latencies.push_back(latencyUs);
+    }
+    else
+    {
+        this->latencies[this->latencySeen % MAX_LATENCY_SAMPLES] = latencyUs;
+    }
+    this->latencySeen++;
+}
+
+BatchController::Decision BatchController::getDecision() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->decision;
+}
+
+std::string BatchController::report() const
+{
+    Decision current = this->getDecision();
+    std::ostringstream out;
+    out << "batching     batch=" << current.batch
+        << " wait=" << current.waitUs << "us"
+        << std::fixed << std::setprecision(1)
+        << " p95=" << current.p95Ms << "ms"
+        << " target=" << this->options.targetMs << "ms"
+        << " arrival=" << current.arrivalFps << "fps"
+        << " infer=" << current.inferMs << "ms"
+        << " capacity=" << current.capacityFps << "fps"
+        << " updates=" << current.updates
+        << " reason=" << current.reason
+        << std::endl;
+    return out.str();
+}
+
+void BatchController::tune(double seconds)
+{
+    double arrivalFps = seconds > 0 ? this->arrivals.exchange(0) / seconds : 0.0;
+    double p95Us = this->latencyP95Us();
+    this->latencies.clear();
+    this->latencySeen = 0;
+
+    Decision next = this->decision;
+    next.p95Ms = p95Us / 1000.0;
+    next.arrivalFps = arrivalFps;
+    next.updates++;
+    double currentUs = this->estimateUs(this->decision.batch);
+    if (currentUs <= 0 || arrivalFps <= 0)
+    {
+        next.reason = currentUs <= 0 ? "warming_up" : "idle";
+        this->decision = next;
+        return;
+    }
+
+    const double targetUs = this->options.targetMs * 1000.0;
+    const double maxWaitUs = static_cast<double>(this->options.maxWaitUs);
+    const double minWaitUs = static_cast<double>(this->options.minWaitUs);
+    // 与凑批无关的延迟（其它级处理和排队）：实测p95减去当前的凑批等待和单批推理耗时
+    double baseUs = p95Us > 0 ? std::max(0.0, p95Us - this->decision.waitUs - currentUs) : 0.0;
+    // 凑批等待时间内最多能凑到的批量，更大的批量只会等到超时
+    size_t reachable = std::min(this->options.maxBatch,
+                                static_cast<size_t>(1.0 + arrivalFps * maxWaitUs / 1e6));
+
+    auto waitFor = [&](size_t batch) {
+        // 凑满一批的预计时间（再留20%余量）作为截止时间
+        double fillUs = (batch - 1) / arrivalFps * 1e6 * 1.2;
+        return static_cast<int64_t>(std::min(maxWaitUs, std::max(minWaitUs, fillUs)));
+    };
+    auto capacity = [&](size_t batch) {
+        return this->options.workers * batch / this->estimateUs(batch) * 1e6;
+    };
+    auto latency = [&](size_t batch) {
+        return baseUs + waitFor(batch) + this->estimateUs(batch);
+    };
+
+    size_t best = 0;            // 吞吐足够且延迟达标的最大批量
+    size_t fastest = 0;         // 吞吐足够、预计延迟最低的批量
+    size_t strongest = 1;       // 吞吐最高的批量（不限凑满）
+    bool latencyLimited = false;
+    for (size_t batch = 1; batch <= this->options.maxBatch; batch++)
+    {
+        if (capacity(batch) > capacity(strongest))
+        {
+            strongest = batch;
+        }
+        if (batch > reachable || capacity(batch) < arrivalFps * CAPACITY_HEADROOM)
+        {
+            continue;
+        }
+        if (fastest == 0 || latency(batch) < latency(fastest))
+        {
+            fastest = batch;
+        }
+        if (latency(batch) <= targetUs * LATENCY_MARGIN)
+        {
+            best = batch;
+        }
+        else
+        {
+            latencyLimited = true;
+        }
+    }
+
+    if (best > 0)
+    {
+        next.batch = best;
+        next.waitUs = waitFor(best);
+        next.reason = latencyLimited ? "latency_bound" : (best < this->options.maxBatch ? "low_load" : "max_throughput");
+    }
+    else if (fastest > 0)
+    {
+        next.batch = fastest;
+        next.waitUs = waitFor(fastest);
+        next.reason = "slo_tight";
+    }
+    else
+    {
+        // 任何批量都跟不上到达帧率：队列积压时批次总能凑满，取吞吐最高的批量
+        next.batch = strongest;
+        next.waitUs = waitFor(strongest);
+        next.reason = "overload";
+    }
+
+    // 实测p95超出目标：在吞吐允许的范围内收缩批量和等待时间，修正估计误差
+    if (p95Us > targetUs && next.reason != "overload")
+    {
+        size_t shrunk = std::max<size_t>(1, this->decision.batch - std::max<size_t>(1, this->decision.batch / 4));
+        if (shrunk < next.batch && capacity(shrunk) >= arrivalFps * CAPACITY_HEADROOM)
+        {
+            next.batch = shrunk;
+        }
+        next.waitUs = std::min(waitFor(next.batch), std::max<int64_t>(this->options.minWaitUs, this->decision.waitUs / 2));
+        next.reason = "slo_violation";
+    }
+
+    next.inferMs = this->estimateUs(next.batch) / 1000.0;
+    next.capacityFps = capacity(next.batch);
+    if (next.batch != this->decision.batch || next.waitUs != this->decision.waitUs)
+    {
+        this->apply(next.batch, next.waitUs);
+    }
+    this->decision = next;
+}
+
+double BatchController::estimateUs(size_t batch) const
+{
+    if (batch < this->times.size() && this->times[batch].count >= MIN_SAMPLES)
+    {
+        return this->times[batch].ewmaUs;
+    }
+    // 按已有样本最小二乘拟合 耗时 = 固定开销 + 逐帧耗时 * 批量
+    double n = 0, sumB = 0, sumT = 0, sumBB = 0, sumBT = 0;
+    for (size_t b = 1; b < this->times.size(); b++)
+    {
+        if (this->times[b].count > 0)
+        {
+            double t = this->times[b].ewmaUs;
+            n++;
+            sumB += b;
+            sumT += t;
+            sumBB += static_cast<double>(b) * b;
+            sumBT += b * t;
+        }
+    }
+    if (n == 0)
+    {
+        return 0.0;
+    }
+    double fixedUs = 0.0;
+    double perItemUs = 0.0;
+    double denominator = n * sumBB - sumB * sumB;
+    if (n >= 2 && denominator > 0)
+    {
+        perItemUs = (n * sumBT - sumB * sumT) / denominator;
+        fixedUs = (sumT - perItemUs * sumB) / n;
+    }
+    if (n < 2 || denominator <= 0 || perItemUs <= 0 || fixedUs < 0)
+    {
+        // 只有一种批量或拟合不合理时，假设固定开销和逐帧耗时各占平均每批耗时的一半
+        double meanB = sumB / n;
+        double meanT = sumT / n;
+        fixedUs = meanT / 2;
+        perItemUs = meanT / 2 / meanB;
+    }
+    return fixedUs + perItemUs * batch;
+}
+
+double BatchController::latencyP95Us()
+{
+    if (this->latencies.empty())
+    {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(std::ceil(0.95 * this->latencies.size())) - 1;
+    std::nth_element(this->latencies.begin(), this->latencies.begin() + index, this->latencies.end());
+    return static_cast<double>(this->latencies[index]);
+}
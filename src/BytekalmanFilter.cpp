@@ -78,7 +78,8 @@ namespace byte_kalman
 	// 预测步骤：根据运动模型预测下一时刻的状态
 	// 参数：mean - 状态均值（输入输出）
 	//      covariance - 状态协方差（输入输出）
-	void ByteKalmanFilter::predict(KAL_MEAN &mean, KAL_COVA &covariance)
+	//      dt - 时间间隔（以帧为单位）
+	void ByteKalmanFilter::predict(KAL_MEAN &mean, KAL_COVA &covariance, float dt)
 	{
 		// 计算过程噪声协方差
 		DETECTBOX std_pos;
@@ -94,13 +95,20 @@ namespace byte_kalman
 		KAL_MEAN tmp;
 		tmp.block<1, 4>(0, 0) = std_pos;
 		tmp.block<1, 4>(0, 4) = std_vel;
-		tmp = tmp.array().square();
+		// 过程噪声方差按时间间隔线性累积
+		tmp = tmp.array().square() * dt;
 		KAL_COVA motion_cov = tmp.asDiagonal();
+
+		// 按时间间隔构造状态转移矩阵（位置 = 位置 + 速度 * dt）
+		Eigen::Matrix<float, 8, 8, Eigen::RowMajor> motion_mat = this->_motion_mat;
+		for (int i = 0; i < 4; i++) {
+			motion_mat(i, 4 + i) = dt;
+		}
 		
 		// 状态预测：mean = F * mean
-		KAL_MEAN mean1 = this->_motion_mat * mean.transpose();
+		KAL_MEAN mean1 = motion_mat * mean.transpose();
 		// 协方差预测：covariance = F * covariance * F^T + motion_cov
-		KAL_COVA covariance1 = this->_motion_mat * covariance *(_motion_mat.transpose());
+		KAL_COVA covariance1 = motion_mat * covariance *(motion_mat.transpose());
 		covariance1 += motion_cov;
 
 		mean = mean1;
@@ -1,4 +1,24 @@
 #include "Detect.h"
+#include <stdexcept>
+
+// 默认锚框（YOLOv5 P3/P4/P5）
+static const string DEFAULT_ANCHORS = "10,13,16,30,33,23;30,61,62,45,59,119;116,90,156,198,373,326";
+
+/**
+ * @brief 是否为端到端（无需NMS）的解码方式
+ */
+static inline bool isEndToEnd(DecodeMode mode)
+{
+    return mode == DECODE_END_TO_END_XYXY || mode == DECODE_END_TO_END_NORM || mode == DECODE_END_TO_END_SPLIT;
+}
+
+/**
+ * @brief sigmoid函数
+ */
+static inline float sigmoid(float x)
+{
+    return 1.0f / (1.0f + std::exp(-x));
+}
 
 /**
  * @brief 默认构造函数
@@ -16,6 +36,19 @@ Detect::~Detect()
     delete this->model;
 }
 
+/**
+ * @brief 读取 param.map 中ORT计算线程绑定的CPU（如 "8-15"）
+ * 
+ * @param dir 模型文件所在目录路径
+ * @return vector<int> CPU编号，未配置时为空
+ */
+static vector<int> configuredOrtCpus(const string &dir)
+{
+    string paramPath = dir + "/param.map";
+    unordered_map<string, string> paramMap = readMap(paramPath);
+    return parseCpuList(paramMap.count("ort_cpus") ? paramMap["ort_cpus"] : "");
+}
+
 /**
  * @brief 带参数的构造函数，初始化检测器
  * 
@@ -25,6 +58,19 @@ Detect::~Detect()
  * @param dir 模型文件所在目录路径
  */
 Detect::Detect(const string dir)
+    : Detect(dir, configuredOrtCpus(dir))
+{
+}
+
+/**
+ * @brief 带参数的构造函数，指定ORT计算线程绑定的CPU
+ * 
+ * 多个NUMA节点各自加载一个检测器时，每个检测器的ORT线程绑定到本节点的CPU。
+ * 
+ * @param dir 模型文件所在目录路径
+ * @param ortCpus ORT计算线程绑定的CPU编号（覆盖 param.map 中的 ort_cpus），为空表示不绑定
+ */
+Detect::Detect(const string dir, const vector<int> &ortCpus)
 {
 
     string classPath = dir + "/names.txt";
@@ -42,8 +88,53 @@ Detect::Detect(const string dir)
     int NumThread = stoi(paramMap["num_thread"]);
 
     string envName = "yolo";
-    this->model = new Model(onnxPath.c_str(), NumThread, envName.c_str(), this->deviceId);
+    // ORT计算线程绑定到指定CPU，与流水线的CPU级线程池分开，避免互相抢占
+    this->model = new Model(onnxPath.c_str(), NumThread, envName.c_str(), this->deviceId, ortCpus);
     this->model->printInfo();
+
+    // RT-DETR 导出需要 orig_target_sizes 输入，传入网络输入尺寸，
+    // 使输出框位于letterbox坐标系，后续沿用 Transformer::reverse
+    for (const string &inputName : this->model->getInputNames())
+    {
+        if (inputName == "orig_target_sizes")
+        {
+            this->model->setAuxInput(inputName, {this->model->getInputDims().at(3), this->model->getInputDims().at(2)});
+        }
+    }
+    // 图像之外的每个输入都必须有取值，否则推理时无法构造输入张量
+    vector<string> inputNames = this->model->getInputNames();
+    for (size_t n = 1; n < inputNames.size(); n++)
+    {
+        if (!this->model->hasAuxInput(inputNames[n]))
+        {
+            throw std::runtime_error("unsupported model input " + inputNames[n] + " (only orig_target_sizes is filled automatically)");
+        }
+    }
+
+    this->decodeMode = this->selectDecodeMode();
+    if (isEndToEnd(this->decodeMode))
+    {
+        // 端到端模式只在显式配置（need_nms=0）或模型自带 orig_target_sizes / labels-boxes-scores 时选中，输出已去重，跳过NMS
+        this->useNms = false;
+    }
+
+    // sigmoid(x) >= conf 等价于 x >= log(conf / (1 - conf))
+    float clampedConf = std::min(std::max(this->objConf, 1e-6f), 1.0f - 1e-6f);
+    this->objLogitThreshold = std::log(clampedConf / (1.0f - clampedConf));
+    if (this->decodeMode == DECODE_RAW_HEAD)
+    {
+        this->buildHeadScales(paramMap.count("anchors") ? paramMap["anchors"] : DEFAULT_ANCHORS);
+    }
+}
+
+/**
+ * @brief 获取类别名称列表
+ * 
+ * @return const vector<string>& 类别名称，下标即类别ID
+ */
+const vector<string> &Detect::getClassNames()
+{
+    return this->classNames;
 }
 
 /**
@@ -76,6 +167,16 @@ int Detect::getBatchSize()
     return this->batchSize;
 }
 
+/**
+ * @brief 获取模型输入尺寸
+ * 
+ * @return cv::Size 输入宽高（与该尺寸相同的图像预处理时不缩放）
+ */
+cv::Size Detect::getInputSize()
+{
+    return cv::Size(static_cast<int>(this->model->getInputDims().at(3)), static_cast<int>(this->model->getInputDims().at(2)));
+}
+
 /**
  * @brief 获取类别数量
  * 
@@ -113,92 +214,607 @@ void Detect::predict(vector<cv::Mat> images,
     inputImages.reserve(images.size());
 
     // 对每张图像进行预处理
-    for (cv::Mat image : images)
+    for (const cv::Mat &image : images)
     {
-        Transformer transformer(image, this->model->getInputDims().at(2), this->model->getInputDims().at(3));
-        transformer.process();
-        inputImages.push_back(transformer.getInputMat());
-        transformers.push_back(transformer);
+        transformers.push_back(this->preprocess(image));
+        inputImages.push_back(transformers.back().getInputMat());
     }
 
     // 使用模型进行推理
-    vector<cv::Mat> predicts = this->model->predict(inputImages);
+    vector<vector<cv::Mat>> predicts = this->infer(inputImages);
 
     // 处理每个推理结果
-    for (int i = 0; i < predicts.size(); i++)
+    for (int i = 0; i < inputImages.size(); i++)
     {
-        cv::Mat predict = predicts[i];
+        vector<cv::Rect> outputRect;
+        vector<string> outputName;
+        vector<float> outputConfidence;
+        this->postprocess(predicts[i], transformers[i], outputRect, outputName, outputConfidence);
+        outputRects.push_back(outputRect);
+        outputConfidences.push_back(outputConfidence);
+        outputNames.push_back(outputName);
+    }
+}
 
-        vector<cv::Rect> boxes;
-        vector<int> classIds;
-        vector<float> confidences;
+/**
+ * @brief 单张图像预处理
+ * 
+ * 按模型输入尺寸做letterbox缩放、填充和归一化。
+ * 
+ * @param image 输入图像
+ * @return Transformer 图像变换器（含模型输入矩阵，后处理时用于坐标反变换）
+ */
+Transformer Detect::preprocess(const cv::Mat &image)
+{
+    Transformer transformer(image, this->model->getInputDims().at(2), this->model->getInputDims().at(3));
+    transformer.process();
+    return transformer;
+}
 
-        // 解析模型输出，提取检测框、类别和置信度
-        for (int i = 0; i < predict.rows; i++)
+/**
+ * @brief 预处理解码时已按letterbox比例缩放的图像
+ * 
+ * @param image 已缩放的输入图像
+ * @param sourceSize 缩放前的原始尺寸，后处理的坐标反变换回该坐标系
+ * @return Transformer 预处理结果
+ */
+Transformer Detect::preprocess(const cv::Mat &image, const cv::Size &sourceSize)
+{
+    Transformer transformer(image, this->model->getInputDims().at(2), this->model->getInputDims().at(3), sourceSize);
+    transformer.process();
+    return transformer;
+}
+
+/**
+ * @brief 批量推理
+ * 
+ * 只做模型推理，不做解码。多个线程可共享同一检测器并发调用。
+ * 
+ * @param inputImages 预处理后的模型输入矩阵列表
+ * @return vector<vector<cv::Mat>> 推理结果，下标依次为 [样本索引][输出索引]
+ */
+vector<vector<cv::Mat>> Detect::infer(const vector<cv::Mat> &inputImages)
+{
+    vector<vector<cv::Mat>> predicts = this->model->predictOutputs(inputImages);
+
+    vector<vector<cv::Mat>> outputs(inputImages.size());
+    for (size_t i = 0; i < inputImages.size(); i++)
+    {
+        outputs[i].reserve(predicts.size());
+        for (const vector<cv::Mat> &predict : predicts)
+        {
+            outputs[i].push_back(predict[i]);
+        }
+    }
+    return outputs;
+}
+
+/**
+ * @brief 单张图像后处理
+ * 
+ * 解码模型输出，按需做非极大值抑制，并将检测框反变换回原图坐标系。
+ * 
+ * @param outputs 单张图像的全部模型输出
+ * @param transformer 该图像预处理时的图像变换器
+ * @param outputRect 输出检测框
+ * @param outputName 输出类别名称
+ * @param outputConfidence 输出置信度
+ */
+void Detect::postprocess(const vector<cv::Mat> &outputs,
+                         Transformer &transformer,
+                         vector<cv::Rect> &outputRect,
+                         vector<string> &outputName,
+                         vector<float> &outputConfidence)
+{
+    vector<cv::Rect> boxes;
+    vector<int> classIds;
+    vector<float> confidences;
+
+    // 解析模型输出，提取检测框、类别和置信度
+    this->decode(outputs, boxes, classIds, confidences);
+
+    // 根据是否使用NMS进行不同处理
+    if (this->useNms){
+        vector<int> indexes;
+        cv::dnn::NMSBoxesBatched(boxes, confidences, classIds, this->objConf, this->nmsConf, indexes);
+
+        outputRect.reserve(indexes.size());
+        outputConfidence.reserve(indexes.size());
+        outputName.reserve(indexes.size());
+
+        // 根据NMS结果提取最终检测结果
+        for (int index : indexes)
         {
-            float conf = predict.at<float>(i, 4);
-            if (conf < this->objConf)
+            outputRect.push_back(boxes.at(index));
+            outputConfidence.push_back(confidences.at(index));
+            outputName.push_back(this->classNames[classIds.at(index)]);
+        }
+    }else{
+        outputName.reserve(classIds.size());
+
+        for (int classId: classIds){
+            outputName.push_back(this->classNames[classId]);
+        }
+        outputRect = boxes;
+        outputConfidence = confidences;
+    }
+    vector<vector<cv::Point>> points;
+    transformer.reverse(outputRect, points);
+}
+
+/**
+ * @brief 获取输出解码方式
+ * 
+ * @return DecodeMode 输出解码方式
+ */
+DecodeMode Detect::getDecodeMode()
+{
+    return this->decodeMode;
+}
+
+/**
+ * @brief 根据模型输出形状选择解码方式
+ * 
+ * 输出为 [B, N, 5+C] 时按行解码（含目标置信度）；
+ * 输出为 [B, 4+C, N] 时按通道解码（YOLOv8/v11 导出格式，无目标置信度）；
+ * 输出为多个 [B, na, H, W, 5+C] 时按原始检测头解码；
+ * 输出为 [B, K, 6]（need_nms=0）、[B, K, 4+C]（need_nms=0 或模型有 orig_target_sizes 输入）
+ * 或 labels/boxes/scores 时按端到端解码；
+ * 其余 [B, N, 4+C] 输出视为转置后的 YOLOv8/v11 导出，按行解码后做NMS。
+ * 
+ * @return DecodeMode 输出解码方式
+ */
+DecodeMode Detect::selectDecodeMode()
+{
+    vector<int64_t> dims = this->model->getOutputNodeDims();
+    int64_t classNum = static_cast<int64_t>(this->classNames.size());
+
+    // labels / boxes / scores 三个输出：RT-DETR官方导出
+    if (this->model->getOutputNum() == 3)
+    {
+        this->labelsOutput = this->boxesOutput = this->scoresOutput = -1;
+        vector<string> outputNames = this->model->getOutputNames();
+        for (int o = 0; o < 3; o++)
+        {
+            vector<int64_t> headDims = this->model->getOutputNodeDims(o);
+            if (headDims.size() == 3 && headDims.at(2) == 4)
             {
-                continue;
+                this->boxesOutput = o;
             }
-            cv::Mat classScores = predict.row(i).colRange(5, 5 + this->classNames.size());
+            else if (outputNames[o].find("label") != string::npos)
+            {
+                this->labelsOutput = o;
+            }
+            else if (outputNames[o].find("score") != string::npos)
+            {
+                this->scoresOutput = o;
+            }
+        }
+        if (this->labelsOutput >= 0 && this->boxesOutput >= 0 && this->scoresOutput >= 0)
+        {
+            std::cout << "输出为 labels/boxes/scores，端到端解码（无NMS）" << std::endl;
+            return DECODE_END_TO_END_SPLIT;
+        }
+    }
 
-            cv::Point classIdPoint;
-            double clsConf;
-            cv::minMaxLoc(classScores, 0, &clsConf, 0, &classIdPoint);
+    // [K, 6] 且配置为不需要NMS：YOLOv10 端到端导出
+    if (!this->useNms && dims.size() == 3 && dims.at(2) == 6 && dims.at(2) != 5 + classNum)
+    {
+        std::cout << "输出布局 [K, 6]，端到端解码（无NMS）" << std::endl;
+        return DECODE_END_TO_END_XYXY;
+    }
 
-            float cx = predict.at<float>(i, 0);
-            float cy = predict.at<float>(i, 1);
-            float w = predict.at<float>(i, 2);
-            float h = predict.at<float>(i, 3);
+    // [K, 4+C]：RT-DETR 归一化框与最终分数；与转置的 YOLOv8/v11 输出形状相同，需显式配置或由 orig_target_sizes 输入确认
+    bool endToEnd = !this->useNms || this->model->hasAuxInput("orig_target_sizes");
+    if (endToEnd && dims.size() == 3 && dims.at(2) == 4 + classNum)
+    {
+        std::cout << "输出布局 [K, 4+C]，端到端解码（无NMS）" << std::endl;
+        return DECODE_END_TO_END_NORM;
+    }
 
-            float left = cx - 0.5f * w;
-            float top = cy - 0.5f * h;
-            cv::Rect box(left, top, w, h);
+    // 多个 [B, na, H, W, 5+C] 输出：未拼接的原始检测头
+    bool rawHead = this->model->getOutputNum() > 1;
+    for (size_t o = 0; rawHead && o < this->model->getOutputNum(); o++)
+    {
+        vector<int64_t> headDims = this->model->getOutputNodeDims(o);
+        rawHead = headDims.size() == 5 && headDims.at(4) == 5 + classNum;
+    }
+    if (rawHead)
+    {
+        std::cout << "输出为多尺度原始检测头，在后处理中解码" << std::endl;
+        return DECODE_RAW_HEAD;
+    }
 
-            boxes.push_back(box);
-            classIds.push_back(classIdPoint.x);
-            confidences.push_back(conf * clsConf);
+    if (dims.size() == 3 && dims.at(2) != 5 + classNum && dims.at(1) == 4 + classNum)
+    {
+        std::cout << "输出布局 [4+C, N]，按通道解码" << std::endl;
+        return DECODE_CHANNEL_MAJOR;
+    }
+    if (dims.size() == 3 && dims.at(2) == 4 + classNum)
+    {
+        std::cout << "输出布局 [N, 4+C]，按行解码（无目标置信度）" << std::endl;
+        return DECODE_ROW_MAJOR;
+    }
+    return DECODE_ANCHOR_MAJOR;
+}
+
+/**
+ * @brief 根据锚框配置预先计算各尺度的网格和锚框表
+ * 
+ * 步长由输入尺寸与特征图尺寸推出，锚框按步长从小到大依次分配给各尺度。
+ * 
+ * @param anchors 锚框配置，如 "10,13,16,30,33,23;30,61,62,45,59,119;116,90,156,198,373,326"
+ */
+void Detect::buildHeadScales(string anchors)
+{
+    vector<string> anchorGroups = stringSplit(anchors, ";");
+    int inputHeight = static_cast<int>(this->model->getInputDims().at(2));
+    size_t outputNum = this->model->getOutputNum();
+
+    // 按步长从小到大排序输出，确定锚框分配顺序
+    vector<size_t> order(outputNum);
+    for (size_t o = 0; o < outputNum; o++)
+    {
+        order[o] = o;
+    }
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b)
+              { return this->model->getOutputNodeDims(a).at(2) > this->model->getOutputNodeDims(b).at(2); });
+
+    this->headScales.assign(outputNum, HeadScale());
+    for (size_t rank = 0; rank < outputNum; rank++)
+    {
+        size_t o = order[rank];
+        vector<int64_t> dims = this->model->getOutputNodeDims(o);
+        HeadScale &scale = this->headScales[o];
+        scale.anchorNum = static_cast<int>(dims.at(1));
+        scale.gridHeight = static_cast<int>(dims.at(2));
+        scale.gridWidth = static_cast<int>(dims.at(3));
+        scale.stride = static_cast<float>(inputHeight) / scale.gridHeight;
+
+        // 网格偏移表
+        int cellNum = scale.gridHeight * scale.gridWidth;
+        scale.offsetX.resize(cellNum);
+        scale.offsetY.resize(cellNum);
+        for (int gy = 0; gy < scale.gridHeight; gy++)
+        {
+            for (int gx = 0; gx < scale.gridWidth; gx++)
+            {
+                scale.offsetX[gy * scale.gridWidth + gx] = (gx - 0.5f) * scale.stride;
+                scale.offsetY[gy * scale.gridWidth + gx] = (gy - 0.5f) * scale.stride;
+            }
+        }
+
+        // 锚框表（预乘 (2*sigmoid)^2 中的系数4）
+        vector<string> values = stringSplit(anchorGroups.at(rank), ",");
+        for (int a = 0; a < scale.anchorNum; a++)
+        {
+            scale.anchorWidth.push_back(4.0f * stof(values.at(2 * a)));
+            scale.anchorHeight.push_back(4.0f * stof(values.at(2 * a + 1)));
+        }
+    }
+}
+
+/**
+ * @brief 解码单张图像的模型输出
+ * 
+ * @param outputs 单张图像的全部模型输出
+ * @param boxes 输出检测框（模型输入坐标系）
+ * @param classIds 输出类别索引
+ * @param confidences 输出置信度
+ */
+void Detect::decode(const vector<cv::Mat> &outputs,
+                    vector<cv::Rect> &boxes,
+                    vector<int> &classIds,
+                    vector<float> &confidences)
+{
+    if (isEndToEnd(this->decodeMode))
+    {
+        this->decodeEndToEnd(outputs, boxes, classIds, confidences);
+    }
+    else if (this->decodeMode == DECODE_RAW_HEAD)
+    {
+        this->decodeRawHead(outputs, boxes, classIds, confidences);
+    }
+    else if (this->decodeMode == DECODE_CHANNEL_MAJOR)
+    {
+        this->decodeChannelMajor(outputs.at(0), boxes, classIds, confidences);
+    }
+    else if (this->decodeMode == DECODE_ROW_MAJOR)
+    {
+        this->decodeRowMajor(outputs.at(0), boxes, classIds, confidences);
+    }
+    else
+    {
+        this->decodeAnchorMajor(outputs.at(0), boxes, classIds, confidences);
+    }
+}
+
+/**
+ * @brief 解码 [N, 5+C] 布局的输出
+ * 
+ * 每行为一个候选框：cx, cy, w, h, 目标置信度, C个类别置信度。
+ * 
+ * @param predict 单张图像的模型输出
+ * @param boxes 输出检测框
+ * @param classIds 输出类别索引
+ * @param confidences 输出置信度
+ */
+void Detect::decodeAnchorMajor(const cv::Mat &predict,
+                               vector<cv::Rect> &boxes,
+                               vector<int> &classIds,
+                               vector<float> &confidences)
+{
+    for (int i = 0; i < predict.rows; i++)
+    {
+        float conf = predict.at<float>(i, 4);
+        if (conf < this->objConf)
+        {
+            continue;
+        }
+        cv::Mat classScores = predict.row(i).colRange(5, 5 + this->classNames.size());
+
+        cv::Point classIdPoint;
+        double clsConf;
+        cv::minMaxLoc(classScores, 0, &clsConf, 0, &classIdPoint);
+
+        float cx = predict.at<float>(i, 0);
+        float cy = predict.at<float>(i, 1);
+        float w = predict.at<float>(i, 2);
+        float h = predict.at<float>(i, 3);
+
+        float left = cx - 0.5f * w;
+        float top = cy - 0.5f * h;
+        cv::Rect box(left, top, w, h);
+
+        boxes.push_back(box);
+        classIds.push_back(classIdPoint.x);
+        confidences.push_back(conf * clsConf);
+    }
+}
+
+/**
+ * @brief 解码 [4+C, N] 布局的输出
+ * 
+ * 前4行为 cx, cy, w, h，其后 C 行为各类别置信度，每列为一个候选框。
+ * 类别最大值按行连续扫描（内层循环无分支，可被编译器向量化），
+ * 只有超过阈值的列才去读取跨行的坐标数据，整个过程不做转置拷贝。
+ * 
+ * @param predict 单张图像的模型输出
+ * @param boxes 输出检测框
+ * @param classIds 输出类别索引
+ * @param confidences 输出置信度
+ * @param anchorIds 输出保留框所在的列（可为空）
+ */
+void Detect::decodeChannelMajor(const cv::Mat &predict,
+                                vector<cv::Rect> &boxes,
+                                vector<int> &classIds,
+                                vector<float> &confidences,
+                                vector<int> *anchorIds)
+{
+    const int anchorNum = predict.cols;
+    const int classNum = static_cast<int>(this->classNames.size());
+
+    // 逐类别行求每个候选框的最大类别置信度
+    const float *firstRow = predict.ptr<float>(4);
+    vector<float> maxScores(firstRow, firstRow + anchorNum);
+    vector<int> maxIds(anchorNum, 0);
+    float *best = maxScores.data();
+    int *ids = maxIds.data();
+    for (int c = 1; c < classNum; c++)
+    {
+        const float *row = predict.ptr<float>(4 + c);
+        for (int j = 0; j < anchorNum; j++)
+        {
+            bool greater = row[j] > best[j];
+            best[j] = greater ? row[j] : best[j];
+            ids[j] = greater ? c : ids[j];
+        }
+    }
+
+    const float *cxRow = predict.ptr<float>(0);
+    const float *cyRow = predict.ptr<float>(1);
+    const float *wRow = predict.ptr<float>(2);
+    const float *hRow = predict.ptr<float>(3);
+    for (int j = 0; j < anchorNum; j++)
+    {
+        if (best[j] < this->objConf)
+        {
+            continue;
+        }
+        float w = wRow[j];
+        float h = hRow[j];
+        float left = cxRow[j] - 0.5f * w;
+        float top = cyRow[j] - 0.5f * h;
+        cv::Rect box(left, top, w, h);
+
+        boxes.push_back(box);
+        classIds.push_back(ids[j]);
+        confidences.push_back(best[j]);
+        if (anchorIds != nullptr)
+        {
+            anchorIds->push_back(j);
+        }
+    }
+}
+
+/**
+ * @brief 解码 [N, 4+C] 布局的输出
+ * 
+ * 每行为一个候选框：cx, cy, w, h, C个类别置信度（YOLOv8/v11 转置导出，无目标置信度）。
+ * 
+ * @param predict 单张图像的模型输出
+ * @param boxes 输出检测框
+ * @param classIds 输出类别索引
+ * @param confidences 输出置信度
+ */
+void Detect::decodeRowMajor(const cv::Mat &predict,
+                            vector<cv::Rect> &boxes,
+                            vector<int> &classIds,
+                            vector<float> &confidences)
+{
+    for (int i = 0; i < predict.rows; i++)
+    {
+        cv::Mat classScores = predict.row(i).colRange(4, 4 + this->classNames.size());
+
+        cv::Point classIdPoint;
+        double clsConf;
+        cv::minMaxLoc(classScores, 0, &clsConf, 0, &classIdPoint);
+        if (clsConf < this->objConf)
+        {
+            continue;
         }
 
-        // 根据是否使用NMS进行不同处理
-        if (this->useNms){
-            vector<int> indexes;
-            cv::dnn::NMSBoxesBatched(boxes, confidences, classIds, this->objConf, this->nmsConf, indexes);
+        float cx = predict.at<float>(i, 0);
+        float cy = predict.at<float>(i, 1);
+        float w = predict.at<float>(i, 2);
+        float h = predict.at<float>(i, 3);
+
+        float left = cx - 0.5f * w;
+        float top = cy - 0.5f * h;
+        cv::Rect box(left, top, w, h);
 
-            vector<cv::Rect> outputRect;
-            vector<float> outputConfidence;
-            vector<string> outputName;
+        boxes.push_back(box);
+        classIds.push_back(classIdPoint.x);
+        confidences.push_back(clsConf);
+    }
+}
 
-            outputRect.reserve(indexes.size());
-            outputConfidence.reserve(indexes.size());
-            outputName.reserve(indexes.size());
+/**
+ * @brief 解码多尺度原始检测头输出
+ * 
+ * 每个输出为 [na, H, W, 5+C] 的未激活logit。目标置信度先在logit空间与阈值比较，
+ * 绝大多数背景网格只需一次比较；通过的网格才计算sigmoid并按预计算的
+ * 网格偏移和锚框表做框变换。类别取logit最大值后只做一次sigmoid。
+ * 
+ * @param outputs 单张图像的各尺度输出
+ * @param boxes 输出检测框
+ * @param classIds 输出类别索引
+ * @param confidences 输出置信度
+ */
+void Detect::decodeRawHead(const vector<cv::Mat> &outputs,
+                           vector<cv::Rect> &boxes,
+                           vector<int> &classIds,
+                           vector<float> &confidences)
+{
+    const int classNum = static_cast<int>(this->classNames.size());
+    const int channelNum = 5 + classNum;
 
-            // 根据NMS结果提取最终检测结果
-            for (int index : indexes)
+    for (size_t s = 0; s < this->headScales.size(); s++)
+    {
+        const HeadScale &scale = this->headScales[s];
+        const float *data = outputs.at(s).ptr<float>();
+        const int cellNum = scale.gridHeight * scale.gridWidth;
+
+        for (int a = 0; a < scale.anchorNum; a++)
+        {
+            const float *anchorData = data + static_cast<size_t>(a) * cellNum * channelNum;
+            for (int cell = 0; cell < cellNum; cell++)
             {
-                outputRect.push_back(boxes.at(index));
-                outputConfidence.push_back(confidences.at(index));
-                outputName.push_back(this->classNames[classIds.at(index)]);
+                const float *row = anchorData + static_cast<size_t>(cell) * channelNum;
+                if (row[4] < this->objLogitThreshold)
+                {
+                    continue;
+                }
+
+                const float *classLogits = row + 5;
+                int classId = static_cast<int>(std::max_element(classLogits, classLogits + classNum) - classLogits);
+                float conf = sigmoid(row[4]) * sigmoid(classLogits[classId]);
+                if (conf < this->objConf)
+                {
+                    continue;
+                }
+
+                float cx = sigmoid(row[0]) * 2.0f * scale.stride + scale.offsetX[cell];
+                float cy = sigmoid(row[1]) * 2.0f * scale.stride + scale.offsetY[cell];
+                float sw = sigmoid(row[2]);
+                float sh = sigmoid(row[3]);
+                float w = sw * sw * scale.anchorWidth[a];
+                float h = sh * sh * scale.anchorHeight[a];
+
+                cv::Rect box(cx - 0.5f * w, cy - 0.5f * h, w, h);
+                boxes.push_back(box);
+                classIds.push_back(classId);
+                confidences.push_back(conf);
             }
-            vector<vector<cv::Point>> points;
-            transformers[i].reverse(outputRect, points);
-            outputRects.push_back(outputRect);
-            outputConfidences.push_back(outputConfidence);
-            outputNames.push_back(outputName);
-        }else{
-            vector<string> outputName;
-            outputName.reserve(classIds.size());
-
-            for (int classId: classIds){
-                outputName.push_back(this->classNames[classId]);
+        }
+    }
+}
+
+/**
+ * @brief 解码端到端（集合预测）输出
+ * 
+ * 三种布局共用同一个固定K次的循环，每个查询只做一次阈值比较，
+ * 后处理耗时与场景中目标数量无关：
+ * - [K, 6]：x1, y1, x2, y2, score, class，坐标位于模型输入坐标系；
+ * - [K, 4+C]：归一化的 cx, cy, w, h 与各类别最终分数；
+ * - labels [K]、boxes [K, 4]、scores [K]：boxes 为 x1, y1, x2, y2，
+ *   已按 orig_target_sizes（即模型输入尺寸）缩放。
+ * 
+ * @param outputs 单张图像的全部模型输出
+ * @param boxes 输出检测框
+ * @param classIds 输出类别索引
+ * @param confidences 输出置信度
+ */
+void Detect::decodeEndToEnd(const vector<cv::Mat> &outputs,
+                            vector<cv::Rect> &boxes,
+                            vector<int> &classIds,
+                            vector<float> &confidences)
+{
+    const int classNum = static_cast<int>(this->classNames.size());
+    const float inputWidth = static_cast<float>(this->model->getInputDims().at(3));
+    const float inputHeight = static_cast<float>(this->model->getInputDims().at(2));
+
+    if (this->decodeMode == DECODE_END_TO_END_SPLIT)
+    {
+        const float *labels = outputs.at(this->labelsOutput).ptr<float>();
+        const float *coords = outputs.at(this->boxesOutput).ptr<float>();
+        const float *scores = outputs.at(this->scoresOutput).ptr<float>();
+        const int queryNum = static_cast<int>(outputs.at(this->scoresOutput).total());
+        for (int k = 0; k < queryNum; k++)
+        {
+            int classId = static_cast<int>(labels[k]);
+            if (scores[k] < this->objConf || classId < 0 || classId >= classNum)
+            {
+                continue;
             }
+            const float *box = coords + 4 * k;
+            boxes.push_back(cv::Rect(box[0], box[1], box[2] - box[0], box[3] - box[1]));
+            classIds.push_back(classId);
+            confidences.push_back(scores[k]);
+        }
+        return;
+    }
 
-            vector<vector<cv::Point>> points;
-            transformers[i].reverse(boxes, points);
-            outputRects.push_back(boxes);
-            outputConfidences.push_back(confidences); 
-            outputNames.push_back(outputName);
+    const cv::Mat &predict = outputs.at(0);
+    for (int k = 0; k < predict.rows; k++)
+    {
+        const float *row = predict.ptr<float>(k);
+        if (this->decodeMode == DECODE_END_TO_END_XYXY)
+        {
+            int classId = static_cast<int>(row[5]);
+            if (row[4] < this->objConf || classId < 0 || classId >= classNum)
+            {
+                continue;
+            }
+            boxes.push_back(cv::Rect(row[0], row[1], row[2] - row[0], row[3] - row[1]));
+            classIds.push_back(classId);
+            confidences.push_back(row[4]);
+        }
+        else
+        {
+            const float *classScores = row + 4;
+            int classId = static_cast<int>(std::max_element(classScores, classScores + classNum) - classScores);
+            if (classScores[classId] < this->objConf)
+            {
+                continue;
+            }
+            float w = row[2] * inputWidth;
+            float h = row[3] * inputHeight;
+            float left = row[0] * inputWidth - 0.5f * w;
+            float top = row[1] * inputHeight - 0.5f * h;
+            boxes.push_back(cv::Rect(left, top, w, h));
+            classIds.push_back(classId);
+            confidences.push_back(classScores[classId]);
         }
     }
 }
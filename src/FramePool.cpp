@@ -0,0 +1,108 @@
+#include "FramePool.h"
+
+FrameRef::FrameRef() : pool(nullptr), slot(-1)
+{
+}
+
+FrameRef::FrameRef(FramePool *pool, int slot) : pool(pool), slot(slot)
+{
+}
+
+FrameRef::FrameRef(const FrameRef &other) : pool(other.pool), slot(other.slot)
+{
+    if (this->pool != nullptr)
+    {
+        this->pool->retain(this->slot);
+    }
+}
+
+FrameRef::FrameRef(FrameRef &&other) noexcept : pool(other.pool), slot(other.slot)
+{
+    other.pool = nullptr;
+    other.slot = -1;
+}
+
+FrameRef &FrameRef::operator=(FrameRef other) noexcept
+{
+    std::swap(this->pool, other.pool);
+    std::swap(this->slot, other.slot);
+    return *this;
+}
+
+FrameRef::~FrameRef()
+{
+    this->reset();
+}
+
+cv::Mat &FrameRef::image() const
+{
+    return this->pool->frames[this->slot];
+}
+
+bool FrameRef::empty() const
+{
+    return this->pool == nullptr;
+}
+
+void FrameRef::reset()
+{
+    if (this->pool != nullptr)
+    {
+        this->pool->release(this->slot);
+        this->pool = nullptr;
+        this->slot = -1;
+    }
+}
+
+FramePool::FramePool(int size, int width, int height, int type)
+    : frames(size), refCounts(new std::atomic<int>[size]), freeSlots(size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        this->frames[i].create(height, width, type);
+        // 由构造线程首次写入，页面分配在该线程所在的NUMA节点上
+        this->frames[i].setTo(cv::Scalar::all(0));
+        this->refCounts[i].store(0);
+        this->freeSlots.tryPush(i);
+    }
+}
+
+FrameRef FramePool::acquire()
+{
+    int slot = -1;
+    if (!this->freeSlots.pop(slot))
+    {
+        return FrameRef();
+    }
+    this->refCounts[slot].store(1, std::memory_order_relaxed);
+    return FrameRef(this, slot);
+}
+
+void FramePool::close()
+{
+    this->freeSlots.close();
+}
+
+size_t FramePool::capacity() const
+{
+    return this->frames.size();
+}
+
+size_t FramePool::available() const
+{
+    return this->freeSlots.size();
+}
+
+void FramePool::retain(int slot)
+{
+    this->refCounts[slot].fetch_add(1, std::memory_order_relaxed);
+}
+
+void FramePool::release(int slot)
+{
+    if (this->refCounts[slot].fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        // 队列容量等于槽位数，归还一定成功
+        this->freeSlots.tryPush(slot);
+    }
+}
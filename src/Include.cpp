@@ -1,4 +1,7 @@
 #include "Include.h"
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
 
 /**
  * @brief 读取文件中的所有行
@@ -59,4 +62,118 @@ unordered_map<string, string> readMap(string &fileName)
         dict[elems.at(0)] = elems.at(1);
     }
     return dict;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief 解析CPU编号列表
+ * 
+ * 以逗号分隔，每项为单个编号或以"-"连接的闭区间。
+ * 
+ * @param cpus 形如 "0-3,8,10-11" 的CPU编号列表，空字符串表示不限制
+ * @return vector<int> CPU编号
+ */
+vector<int> parseCpuList(const string &cpus)
+{
+    vector<int> result;
+    string list = cpus;
+    for (const string &item : stringSplit(list, ","))
+    {
+        if (item.empty())
+        {
+            continue;
+        }
+        size_t dash = item.find('-');
+        if (dash == string::npos)
+        {
+            result.push_back(stoi(item));
+            continue;
+        }
+        int first = stoi(item.substr(0, dash));
+        int last = stoi(item.substr(dash + 1));
+        for (int cpu = first; cpu <= last; cpu++)
+        {
+            result.push_back(cpu);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 读取sysfs中的CPU编号列表文件
+ * 
+ * @param path 文件路径
+ * @return vector<int> CPU编号，文件不存在时为空
+ */
+static vector<int> readCpuListFile(const string &path)
+{
+    std::ifstream file(path);
+    string line;
+    if (!file.is_open() || !std::getline(file, line))
+    {
+        return vector<int>();
+    }
+    return parseCpuList(line);
+}
+
+/**
+ * @brief 获取在线的NUMA节点编号
+ * 
+ * @return vector<int> 节点编号，系统不支持NUMA时为 {0}
+ */
+vector<int> numaNodes()
+{
+    vector<int> nodes = readCpuListFile("/sys/devices/system/node/online");
+    return nodes.empty() ? vector<int>{0} : nodes;
+}
+
+/**
+ * @brief 获取NUMA节点上的CPU编号
+ * 
+ * @param node 节点编号
+ * @return vector<int> CPU编号，无法读取时为空
+ */
+vector<int> numaNodeCpus(int node)
+{
+    return readCpuListFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+}
+
+/**
+ * @brief CPU集合求交集
+ * 
+ * @param cpus CPU编号
+ * @param allowed 允许的CPU编号
+ * @return vector<int> 同时出现在两者中的CPU编号（保持 cpus 中的顺序）
+ */
+vector<int> intersectCpus(const vector<int> &cpus, const vector<int> &allowed)
+{
+    vector<int> result;
+    for (int cpu : cpus)
+    {
+        if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end())
+        {
+            result.push_back(cpu);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 将调用线程绑定到指定CPU集合
+ * 
+ * @param cpus CPU编号，为空时不做任何操作
+ * @return bool 绑定成功或无需绑定返回true
+ */
+bool pinCurrentThread(const vector<int> &cpus)
+{
+    if (cpus.empty())
+    {
+        return true;
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : cpus)
+    {
+        CPU_SET(cpu, &cpuSet);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) == 0;
+}
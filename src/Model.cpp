@@ -1,4 +1,5 @@
 #include "Model.h"
+#include <stdexcept>
 
 /**
  * @brief 默认构造函数
@@ -42,9 +43,26 @@ Model::Model(const char *onnxPath, const int NumThread, const char *envName)
  * @param cudaId CUDA设备ID，-1表示使用CPU
  */
 Model::Model(const char *onnxPath, const int NumThread, const char *envName, const int cudaId)
+    : Model(onnxPath, NumThread, envName, cudaId, vector<int>())
+{
+}
+
+/**
+ * @brief 构造函数，CPU推理时将ORT计算线程绑定到指定CPU
+ * 
+ * 调用Run的线程本身也参与计算，ORT只另外创建 cpus.size() - 1 个线程，
+ * 分别绑定到 cpus[1] 之后的CPU；cpus[0] 留给调用线程自行绑定。
+ * 
+ * @param onnxPath ONNX模型文件路径
+ * @param NumThread CPU推理线程数，cpus非空时取cpus的个数
+ * @param envName 环境名称
+ * @param cudaId CUDA设备ID，-1表示使用CPU
+ * @param cpus ORT计算线程绑定的CPU编号，为空表示不绑定
+ */
+Model::Model(const char *onnxPath, const int NumThread, const char *envName, const int cudaId, const vector<int> &cpus)
 {
     this->onnxPath = onnxPath;
-    this->NumThread = NumThread;
+    this->NumThread = cpus.empty() ? NumThread : static_cast<int>(cpus.size());
     this->envName = envName;
 
     Ort::SessionOptions sessionOptions;
@@ -59,7 +77,19 @@ Model::Model(const char *onnxPath, const int NumThread, const char *envName, con
     {
         std::cout << "Your ORT build without GPU. Changle to CPU" << std::endl;
         std::cout << "Infer model on CPU" << std::endl;
-        sessionOptions.SetIntraOpNumThreads(NumThread);
+        sessionOptions.SetIntraOpNumThreads(this->NumThread);
+        if (cpus.size() > 1)
+        {
+            // 每个ORT线程一项，以分号分隔；ORT的逻辑处理器编号从1开始
+            string affinities;
+            for (size_t i = 1; i < cpus.size(); i++)
+            {
+                affinities += (i > 1 ? ";" : "") + std::to_string(cpus[i] + 1);
+            }
+            sessionOptions.AddConfigEntry("session.intra_op_thread_affinities", affinities.c_str());
+            // 计算线程独占绑定的核心，空闲时不自旋抢占其它线程
+            sessionOptions.AddConfigEntry("session.intra_op.allow_spinning", "0");
+        }
     }
     else
     {
@@ -95,8 +125,10 @@ Model::Model(const char *onnxPath, const int NumThread, const char *envName, con
         this->input_node_names.push_back(input_name.get());
         auto input_type_info = this->ort_session->GetInputTypeInfo(i);
         auto input_tensor_info = input_type_info.GetTensorTypeAndShapeInfo();
-        this->input_node_dims = input_tensor_info.GetShape();
+        this->input_node_dims_list.push_back(input_tensor_info.GetShape());
+        this->input_node_types.push_back(input_tensor_info.GetElementType());
     }
+    this->input_node_dims = this->input_node_dims_list.at(0);
 
     // 获取模型输出信息
     this->num_output_nodes = this->ort_session->GetOutputCount();
@@ -108,8 +140,10 @@ Model::Model(const char *onnxPath, const int NumThread, const char *envName, con
         this->output_node_names.push_back(output_name.get());
         auto output_type_info = this->ort_session->GetOutputTypeInfo(i);
         auto output_tensor_info = output_type_info.GetTensorTypeAndShapeInfo();
-        this->output_node_dims = output_tensor_info.GetShape();
+        this->output_node_dims_list.push_back(output_tensor_info.GetShape());
+        this->output_node_types.push_back(output_tensor_info.GetElementType());
     }
+    this->output_node_dims = this->output_node_dims_list.at(0);
 
     // 计算输入和输出维度的乘积（批量大小除外）
     this->input_dim_product = 1L;
@@ -117,11 +151,16 @@ Model::Model(const char *onnxPath, const int NumThread, const char *envName, con
     {
         this->input_dim_product = this->input_dim_product * this->input_node_dims.at(d);
     }
-    this->output_dim_produt = 1L;
-    for (int64_t d = 1; d < this->output_node_dims.size(); d++)
+    for (const vector<int64_t> &dims : this->output_node_dims_list)
     {
-        this->output_dim_produt = this->output_dim_produt * this->output_node_dims.at(d);
+        int64_t product = 1L;
+        for (int64_t d = 1; d < dims.size(); d++)
+        {
+            product = product * dims.at(d);
+        }
+        this->output_dim_products.push_back(product);
     }
+    this->output_dim_produt = this->output_dim_products.at(0);
 }
 
 /**
@@ -154,6 +193,28 @@ const vector<int64_t> Model::getInputDims()
     return this->input_node_dims;
 }
 
+/**
+ * @brief 设置附加输入的取值
+ * 
+ * @param name 输入节点名称
+ * @param values 单个样本的取值
+ */
+void Model::setAuxInput(const string &name, const vector<int64_t> &values)
+{
+    this->aux_inputs[name] = values;
+}
+
+/**
+ * @brief 是否已设置附加输入的取值
+ * 
+ * @param name 输入节点名称
+ * @return bool 已通过 setAuxInput 设置返回true
+ */
+bool Model::hasAuxInput(const string &name) const
+{
+    return this->aux_inputs.count(name) > 0;
+}
+
 /**
  * @brief 获取输出节点数量
  * 
@@ -184,6 +245,17 @@ const vector<int64_t> Model::getOutputNodeDims()
     return this->output_node_dims;
 }
 
+/**
+ * @brief 获取指定输出节点的维度信息
+ * 
+ * @param index 输出节点索引
+ * @return const vector<int64_t> 输出节点维度信息
+ */
+const vector<int64_t> Model::getOutputNodeDims(size_t index)
+{
+    return this->output_node_dims_list.at(index);
+}
+
 /**
  * @brief 打印模型信息
  * 
@@ -200,10 +272,11 @@ void Model::printInfo()
     for (size_t i = 0; i < num_input_nodes; i++)
     {
         cout << "Input " << i << " : name =" << this->input_node_names[i] << endl;
-        cout << "Input " << i << " : num_dims = " << this->input_node_dims.size() << '\n';
-        for (size_t j = 0; j < this->input_node_dims.size(); j++)
+        const vector<int64_t> &dims = this->input_node_dims_list[i];
+        cout << "Input " << i << " : num_dims = " << dims.size() << '\n';
+        for (size_t j = 0; j < dims.size(); j++)
         {
-            cout << "Input " << i << " : dim[" << j << "] =" << this->input_node_dims[j] << '\n';
+            cout << "Input " << i << " : dim[" << j << "] =" << dims[j] << '\n';
         }
         cout << flush;
     }
@@ -212,10 +285,11 @@ void Model::printInfo()
     for (size_t i = 0; i < num_output_nodes; i++)
     {
         cout << "Output " << i << " : name =" << this->output_node_names[i] << endl;
-        cout << "Output " << i << " : num_dims = " << this->output_node_dims.size() << '\n';
-        for (size_t j = 0; j < this->output_node_dims.size(); j++)
+        const vector<int64_t> &dims = this->output_node_dims_list[i];
+        cout << "Output " << i << " : num_dims = " << dims.size() << '\n';
+        for (size_t j = 0; j < dims.size(); j++)
         {
-            cout << "Output " << i << " : dim[" << j << "] =" << this->output_node_dims[j] << '\n';
+            cout << "Output " << i << " : dim[" << j << "] =" << dims[j] << '\n';
         }
         cout << flush;
     }
@@ -224,22 +298,33 @@ void Model::printInfo()
 /**
  * @brief 执行模型推理
  * 
- * 对输入的预处理图像进行批量推理，返回模型输出结果。
- * 主要步骤包括：构建输入张量、执行推理、处理输出张量。
+ * 对输入的预处理图像进行批量推理，返回第一个输出的结果。
  * 
  * @param images 预处理后的输入图像列表
  * @return vector<cv::Mat> 推理结果，每个元素对应一个样本的输出
  */
 vector<cv::Mat> Model::predict(vector<cv::Mat> images)
+{
+    return this->predictOutputs(images).at(0);
+}
+
+/**
+ * @brief 执行模型推理并返回所有输出
+ * 
+ * 对输入的预处理图像进行批量推理，返回模型全部输出结果。
+ * 主要步骤包括：构建输入张量、执行推理、处理输出张量。
+ * 每个输出直接写入一块连续的 cv::Mat，按样本切分行区间返回，不做额外拷贝。
+ * 
+ * @param images 预处理后的输入图像列表
+ * @return vector<vector<cv::Mat>> 推理结果，下标依次为 [输出索引][样本索引]
+ */
+vector<vector<cv::Mat>> Model::predictOutputs(vector<cv::Mat> images)
 {
     int64_t batch_size = images.size();
 
     size_t inputTensorSize = this->input_dim_product * batch_size;
     vector<float> inputTensorValues(inputTensorSize);
 
-    size_t outputTensorSize = this->output_dim_produt * batch_size;
-    vector<float> outputTensorValues(outputTensorSize);
-
     // 将图像数据复制到输入张量中
     for (int i = 0; i < batch_size; ++i)
     {
@@ -255,22 +340,87 @@ vector<cv::Mat> Model::predict(vector<cv::Mat> images)
     vector<int64_t> inputShape = this->input_node_dims;
     inputShape.at(0) = batch_size;
 
-    // 构建输出张量形状（添加批量维度）
-    vector<int64_t> outputShape = this->output_node_dims;
-    outputShape.at(0) = batch_size;
-
-    // 创建输入和输出张量
+    // 创建输入张量
     Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
     inputTensors.push_back(Ort::Value::CreateTensor<float>(memoryInfo,
                                                            inputTensorValues.data(),
                                                            inputTensorSize,
                                                            inputShape.data(),
                                                            inputShape.size()));
-    outputTensors.push_back(Ort::Value::CreateTensor<float>(memoryInfo,
-                                                            outputTensorValues.data(),
-                                                            outputTensorSize,
-                                                            outputShape.data(),
-                                                            outputShape.size()));
+
+    // 附加输入（如 orig_target_sizes），按批量大小重复单样本取值
+    vector<vector<int64_t>> auxShapes(this->num_input_nodes);
+    vector<vector<int64_t>> auxInt64Values(this->num_input_nodes);
+    vector<vector<float>> auxFloatValues(this->num_input_nodes);
+    for (size_t n = 1; n < this->num_input_nodes; n++)
+    {
+        // 只读查找：推理可能在多个线程中并发进行
+        auto found = this->aux_inputs.find(this->input_node_names[n]);
+        if (found == this->aux_inputs.end())
+        {
+            throw std::runtime_error("no value set for model input " + this->input_node_names[n]);
+        }
+        const vector<int64_t> &values = found->second;
+        auxShapes[n] = this->input_node_dims_list[n];
+        auxShapes[n].at(0) = batch_size;
+        if (auxShapes[n].size() > 1)
+        {
+            auxShapes[n].at(1) = static_cast<int64_t>(values.size());
+        }
+        for (int64_t b = 0; b < batch_size; b++)
+        {
+            auxInt64Values[n].insert(auxInt64Values[n].end(), values.begin(), values.end());
+        }
+
+        if (this->input_node_types[n] == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64)
+        {
+            inputTensors.push_back(Ort::Value::CreateTensor<int64_t>(memoryInfo,
+                                                                     auxInt64Values[n].data(),
+                                                                     auxInt64Values[n].size(),
+                                                                     auxShapes[n].data(),
+                                                                     auxShapes[n].size()));
+        }
+        else
+        {
+            auxFloatValues[n].assign(auxInt64Values[n].begin(), auxInt64Values[n].end());
+            inputTensors.push_back(Ort::Value::CreateTensor<float>(memoryInfo,
+                                                                   auxFloatValues[n].data(),
+                                                                   auxFloatValues[n].size(),
+                                                                   auxShapes[n].data(),
+                                                                   auxShapes[n].size()));
+        }
+    }
+
+    // 为每个输出创建张量：形状固定的float输出直接写入一块连续的 cv::Mat，
+    // 其余（整型标签、动态形状）由ORT分配，推理后再转换
+    vector<vector<int64_t>> outputShapes(this->num_output_nodes);
+    vector<cv::Mat> outputTensorMats(this->num_output_nodes);
+    for (size_t o = 0; o < this->num_output_nodes; o++)
+    {
+        outputShapes[o] = this->output_node_dims_list[o];
+        outputShapes[o].at(0) = batch_size;
+
+        bool staticShape = this->output_dim_products[o] > 0;
+        for (size_t d = 1; d < outputShapes[o].size(); d++)
+        {
+            staticShape = staticShape && outputShapes[o][d] > 0;
+        }
+        if (!staticShape || this->output_node_types[o] != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT)
+        {
+            outputTensors.push_back(Ort::Value{nullptr});
+            continue;
+        }
+
+        int outputRows = outputShapes[o].size() > 1 ? static_cast<int>(outputShapes[o][1]) : 1;
+        int outputCols = static_cast<int>(this->output_dim_products[o] / outputRows);
+        outputTensorMats[o].create(static_cast<int>(batch_size) * outputRows, outputCols, CV_32F);
+
+        outputTensors.push_back(Ort::Value::CreateTensor<float>(memoryInfo,
+                                                                outputTensorMats[o].ptr<float>(),
+                                                                this->output_dim_products[o] * batch_size,
+                                                                outputShapes[o].data(),
+                                                                outputShapes[o].size()));
+    }
 
     // 构建输入和输出节点名称列表
     vector<const char *> inputNames(this->input_node_names.size(), nullptr);
@@ -294,17 +444,49 @@ vector<cv::Mat> Model::predict(vector<cv::Mat> images)
                            outputTensors.data(),
                            this->num_output_nodes);
 
-    // 处理推理结果
-    vector<cv::Mat> predicts;
-    for (int batch_id = 0; batch_id < batch_size; batch_id++)
+    // 将ORT分配的输出转换为 CV_32F 矩阵
+    for (size_t o = 0; o < this->num_output_nodes; o++)
     {
-        vector<float> predict(this->output_dim_produt);
-        copy(outputTensorValues.data() + batch_id * this->output_dim_produt,
-             outputTensorValues.data() + (batch_id + 1) * this->output_dim_produt,
-             predict.begin());
+        if (!outputTensorMats[o].empty())
+        {
+            continue;
+        }
+        auto outputInfo = outputTensors[o].GetTensorTypeAndShapeInfo();
+        vector<int64_t> shape = outputInfo.GetShape();
+        size_t count = outputInfo.GetElementCount();
+        int outputRows = shape.size() > 1 ? static_cast<int>(shape[1]) : 1;
+        int outputCols = static_cast<int>(count / (batch_size * outputRows));
+        outputTensorMats[o].create(static_cast<int>(batch_size) * outputRows, outputCols, CV_32F);
+
+        float *dst = outputTensorMats[o].ptr<float>();
+        ONNXTensorElementDataType type = outputInfo.GetElementType();
+        if (type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64)
+        {
+            const int64_t *src = outputTensors[o].GetTensorData<int64_t>();
+            std::transform(src, src + count, dst, [](int64_t v) { return static_cast<float>(v); });
+        }
+        else if (type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32)
+        {
+            const int32_t *src = outputTensors[o].GetTensorData<int32_t>();
+            std::transform(src, src + count, dst, [](int32_t v) { return static_cast<float>(v); });
+        }
+        else
+        {
+            const float *src = outputTensors[o].GetTensorData<float>();
+            std::copy(src, src + count, dst);
+        }
+    }
 
-        cv::Mat predictMat(this->output_node_dims[1], this->output_node_dims[2], CV_32F, predict.data());
-        predicts.push_back(predictMat);
+    // 处理推理结果（每个样本共享输出内存的行区间）
+    vector<vector<cv::Mat>> predicts(this->num_output_nodes);
+    for (size_t o = 0; o < this->num_output_nodes; o++)
+    {
+        int outputRows = outputTensorMats[o].rows / static_cast<int>(batch_size);
+        predicts[o].reserve(batch_size);
+        for (int batch_id = 0; batch_id < batch_size; batch_id++)
+        {
+            predicts[o].push_back(outputTensorMats[o].rowRange(batch_id * outputRows, (batch_id + 1) * outputRows));
+        }
     }
     return predicts;
 }
@@ -0,0 +1,165 @@
+#include "MosaicPacker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// 检测框越出所在区域或贴近区域内部边界的容差（像素）
+const int EDGE_TOLERANCE = 2;
+
+/**
+ * @brief 画布上的一层货架
+ */
+struct Shelf
+{
+    int y;                          // 顶部位置
+    int height;                     // 高度（首个区域的高度）
+    int x;                          // 下一个区域的左侧位置
+};
+}
+
+MosaicPacker::MosaicPacker(const cv::Size &canvasSize, int gap, const cv::Scalar &fill)
+    : canvasSize(canvasSize), gap(std::max(0, gap)), fill(fill)
+{
+}
+
+std::vector<MosaicPacker::Canvas> MosaicPacker::pack(const std::vector<Tile> &tiles) const
+{
+    const int usableWidth = this->canvasSize.width - 2 * this->gap;
+    const int usableHeight = this->canvasSize.height - 2 * this->gap;
+
+    // 区域以原始分辨率放置，大于画布可用范围时等比缩小
+    std::vector<cv::Size> sizes(tiles.size());
+    std::vector<double> scales(tiles.size(), 1.0);
+    for (size_t i = 0; i < tiles.size(); i++)
+    {
+        const cv::Rect &roi = tiles[i].roi;
+        scales[i] = std::min(1.0, std::min(static_cast<double>(usableWidth) / roi.width,
+                                           static_cast<double>(usableHeight) / roi.height));
+        sizes[i] = cv::Size(std::max(1, static_cast<int>(roi.width * scales[i])),
+                            std::max(1, static_cast<int>(roi.height * scales[i])));
+    }
+
+    // 按高度降序逐个放入第一层放得下的货架，没有时在剩余高度上开新层，画布放满时开新画布
+    std::vector<size_t> order(tiles.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a].height > sizes[b].height; });
+
+    std::vector<Canvas> canvases;
+    std::vector<std::vector<Shelf>> shelves;
+    for (size_t index : order)
+    {
+        const cv::Size &size = sizes[index];
+        cv::Rect placed;
+        size_t target = canvases.size();
+        for (size_t c = 0; c < canvases.size() && placed.area() == 0; c++)
+        {
+            for (Shelf &shelf : shelves[c])
+            {
+                if (size.height <= shelf.height && shelf.x + size.width <= this->gap + usableWidth)
+                {
+                    placed = cv::Rect(shelf.x, shelf.y, size.width, size.height);
+                    shelf.x += size.width + this->gap;
+                    target = c;
+                    break;
+                }
+            }
+            if (placed.area() == 0)
+            {
+                int top = shelves[c].empty() ? this->gap : shelves[c].back().y + shelves[c].back().height + this->gap;
+                if (top + size.height <= this->gap + usableHeight)
+                {
+                    shelves[c].push_back(Shelf{top, size.height, this->gap + size.width + this->gap});
+                    placed = cv::Rect(this->gap, top, size.width, size.height);
+                    target = c;
+                }
+            }
+        }
+        if (placed.area() == 0)
+        {
+            Canvas canvas;
+            canvas.image = cv::Mat(this->canvasSize, CV_8UC3, this->fill);
+            canvases.push_back(canvas);
+            shelves.push_back(std::vector<Shelf>{Shelf{this->gap, size.height, this->gap + size.width + this->gap}});
+            placed = cv::Rect(this->gap, this->gap, size.width, size.height);
+            target = canvases.size() - 1;
+        }
+
+        Canvas &canvas = canvases[target];
+        cv::Mat region = canvas.image(placed);
+        cv::Mat source = tiles[index].image(tiles[index].roi);
+        if (scales[index] < 1.0)
+        {
+            cv::resize(source, region, placed.size(), 0, 0, cv::INTER_AREA);
+        }
+        else
+        {
+            source.copyTo(region);
+        }
+        Placement placement;
+        placement.tile = index;
+        placement.rect = placed;
+        placement.scale = scales[index];
+        canvas.placements.push_back(placement);
+    }
+    return canvases;
+}
+
+void MosaicPacker::unpack(const Canvas &canvas,
+                          const std::vector<Tile> &tiles,
+                          const std::vector<cv::Rect> &rects,
+                          const std::vector<string> &names,
+                          const std::vector<float> &confidences,
+                          std::vector<Detection> &detections) const
+{
+    for (size_t i = 0; i < rects.size(); i++)
+    {
+        const cv::Rect &box = rects[i];
+        cv::Point center(box.x + box.width / 2, box.y + box.height / 2);
+        for (const Placement &placement : canvas.placements)
+        {
+            const cv::Rect &rect = placement.rect;
+            if (!rect.contains(center))
+            {
+                continue;
+            }
+            // 跨出所在区域的框横跨了相邻区域或空白，不对应任何真实目标
+            if (box.x < rect.x - EDGE_TOLERANCE || box.y < rect.y - EDGE_TOLERANCE ||
+                box.x + box.width > rect.x + rect.width + EDGE_TOLERANCE ||
+                box.y + box.height > rect.y + rect.height + EDGE_TOLERANCE)
+            {
+                break;
+            }
+            // 贴在区域内部裁剪边界上的框对应被截断的目标；区域边界与来源图像边界重合时保留
+            const Tile &tile = tiles[placement.tile];
+            cv::Size sourceSize = tile.image.size();
+            if ((tile.roi.x > 0 && box.x <= rect.x + EDGE_TOLERANCE) ||
+                (tile.roi.y > 0 && box.y <= rect.y + EDGE_TOLERANCE) ||
+                (tile.roi.x + tile.roi.width < sourceSize.width && box.x + box.width >= rect.x + rect.width - EDGE_TOLERANCE) ||
+                (tile.roi.y + tile.roi.height < sourceSize.height && box.y + box.height >= rect.y + rect.height - EDGE_TOLERANCE))
+            {
+                break;
+            }
+            cv::Rect local = box & rect;
+            Detection detection;
+            detection.tile = placement.tile;
+            detection.source = tile.source;
+            detection.box = cv::Rect(tile.roi.x + static_cast<int>(std::round((local.x - rect.x) / placement.scale)),
+                                     tile.roi.y + static_cast<int>(std::round((local.y - rect.y) / placement.scale)),
+                                     static_cast<int>(std::round(local.width / placement.scale)),
+                                     static_cast<int>(std::round(local.height / placement.scale)));
+            detection.name = names.at(i);
+            detection.confidence = confidences.at(i);
+            detections.push_back(detection);
+            break;
+        }
+    }
+}
+
+cv::Size MosaicPacker::getCanvasSize() const
+{
+    return this->canvasSize;
+}
@@ -0,0 +1,114 @@
+#include "MotionRegions.h"
+#include <algorithm>
+#include <cmath>
+
+MotionRegions::MotionRegions(const Options &options)
+    : options(options), changedRatio(0.0)
+{
+    this->options.width = std::max(8, options.width);
+}
+
+std::vector<cv::Rect> MotionRegions::update(const cv::Mat &frame)
+{
+    cv::Rect frameRect(0, 0, frame.cols, frame.rows);
+    cv::Size modelSize(this->options.width,
+                       std::max(1, static_cast<int>(std::lround(static_cast<double>(this->options.width) * frame.rows / frame.cols))));
+    cv::Mat small;
+    cv::Mat gray;
+    cv::resize(frame, small, modelSize, 0, 0, cv::INTER_AREA);
+    cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+    if (this->background.empty() || this->frameSize != frame.size())
+    {
+        gray.convertTo(this->background, CV_32F);
+        this->frameSize = frame.size();
+        this->changedRatio = 1.0;
+        return std::vector<cv::Rect>{frameRect};
+    }
+
+    cv::Mat reference;
+    cv::Mat mask;
+    this->background.convertTo(reference, CV_8U);
+    cv::absdiff(gray, reference, mask);
+    cv::threshold(mask, mask, this->options.threshold, 255, cv::THRESH_BINARY);
+    // 膨胀连接同一目标上断开的变化像素
+    cv::dilate(mask, mask, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
+    this->changedRatio = static_cast<double>(cv::countNonZero(mask)) / mask.total();
+    cv::accumulateWeighted(gray, this->background, this->options.learningRate);
+
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    std::vector<cv::Rect> regions;
+    for (const std::vector<cv::Point> &contour : contours)
+    {
+        cv::Rect region = cv::boundingRect(contour);
+        if (region.area() >= this->options.minArea)
+        {
+            regions.push_back(region);
+        }
+    }
+    merge(regions, this->options.mergeGap, this->options.maxRegions);
+
+    // 映射回原图，外扩后再合并一次（外扩可能使区域重叠）
+    double scaleX = static_cast<double>(frame.cols) / modelSize.width;
+    double scaleY = static_cast<double>(frame.rows) / modelSize.height;
+    for (cv::Rect &region : regions)
+    {
+        double w = std::max<double>(region.width * scaleX * (1 + 2 * this->options.margin), this->options.minSize);
+        double h = std::max<double>(region.height * scaleY * (1 + 2 * this->options.margin), this->options.minSize);
+        double cx = (region.x + region.width / 2.0) * scaleX;
+        double cy = (region.y + region.height / 2.0) * scaleY;
+        region = cv::Rect(static_cast<int>(cx - w / 2), static_cast<int>(cy - h / 2), static_cast<int>(std::ceil(w)), static_cast<int>(std::ceil(h))) & frameRect;
+    }
+    regions.erase(std::remove_if(regions.begin(), regions.end(), [](const cv::Rect &region) { return region.area() == 0; }),
+                  regions.end());
+    merge(regions, 0, this->options.maxRegions);
+    return regions;
+}
+
+double MotionRegions::getChangedRatio() const
+{
+    return this->changedRatio;
+}
+
+void MotionRegions::merge(std::vector<cv::Rect> &regions, int gap, size_t maxRegions)
+{
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t i = 0; i < regions.size() && !merged; i++)
+        {
+            cv::Rect expanded(regions[i].x - gap, regions[i].y - gap, regions[i].width + 2 * gap, regions[i].height + 2 * gap);
+            for (size_t j = i + 1; j < regions.size() && !merged; j++)
+            {
+                if ((expanded & regions[j]).area() > 0)
+                {
+                    regions[i] |= regions[j];
+                    regions.erase(regions.begin() + j);
+                    merged = true;
+                }
+            }
+        }
+    }
+    while (maxRegions > 0 && regions.size() > maxRegions)
+    {
+        size_t bestI = 0;
+        size_t bestJ = 1;
+        int bestGrowth = -1;
+        for (size_t i = 0; i < regions.size(); i++)
+        {
+            for (size_t j = i + 1; j < regions.size(); j++)
+            {
+                int growth = (regions[i] | regions[j]).area() - regions[i].area() - regions[j].area();
+                if (bestGrowth < 0 || growth < bestGrowth)
+                {
+                    bestI = i;
+                    bestJ = j;
+                    bestGrowth = std::max(0, growth);
+                }
+            }
+        }
+        regions[bestI] |= regions[bestJ];
+        regions.erase(regions.begin() + bestJ);
+    }
+}
@@ -0,0 +1,112 @@
+#include "ObbDetect.h"
+
+/**
+ * @brief 默认构造函数
+ */
+ObbDetect::ObbDetect(/* args */)
+{
+}
+
+/**
+ * @brief 带参数的构造函数，初始化旋转目标检测器
+ * 
+ * @param dir 模型文件所在目录路径
+ */
+ObbDetect::ObbDetect(string dir) : Detect(dir)
+{
+    // 输出 [B, 4+C+1, N]，类别之后的角度行在解码时被跳过
+    this->decodeMode = DECODE_CHANNEL_MAJOR;
+}
+
+/**
+ * @brief 执行旋转目标检测预测
+ * 
+ * 复用按通道解码得到候选框与类别，再按列取出角度构造旋转框，
+ * 经旋转框NMS后变换回原图坐标系。
+ * 
+ * @param images 输入图像列表
+ * @param outputBoxes 输出旋转框列表
+ * @param outputNames 输出类别名称列表
+ * @param outputConfidences 输出置信度列表
+ */
+void ObbDetect::predict(vector<cv::Mat> images,
+                        vector<vector<cv::RotatedRect>> &outputBoxes,
+                        vector<vector<string>> &outputNames,
+                        vector<vector<float>> &outputConfidences)
+{
+    // 创建图像变换器和预处理后的图像列表
+    vector<Transformer> transformers;
+    transformers.reserve(images.size());
+    vector<cv::Mat> inputImages;
+    inputImages.reserve(images.size());
+
+    // 对每张图像进行预处理
+    for (cv::Mat image : images)
+    {
+        Transformer transformer(image, this->model->getInputDims().at(2), this->model->getInputDims().at(3));
+        transformer.process();
+        inputImages.push_back(transformer.getInputMat());
+        transformers.push_back(transformer);
+    }
+
+    // 使用模型进行推理
+    vector<cv::Mat> predicts = this->model->predict(inputImages);
+
+    const int angleRow = 4 + static_cast<int>(this->classNames.size());
+    for (int i = 0; i < predicts.size(); i++)
+    {
+        cv::Mat predict = predicts[i];
+
+        vector<cv::Rect> rects;
+        vector<int> classIds;
+        vector<float> confidences;
+        vector<int> anchorIds;
+        this->decodeChannelMajor(predict, rects, classIds, confidences, &anchorIds);
+
+        // 构造旋转框（角度由弧度转换为度）
+        const float *angles = predict.ptr<float>(angleRow);
+        const float *cxRow = predict.ptr<float>(0);
+        const float *cyRow = predict.ptr<float>(1);
+        const float *wRow = predict.ptr<float>(2);
+        const float *hRow = predict.ptr<float>(3);
+        vector<cv::RotatedRect> boxes;
+        boxes.reserve(anchorIds.size());
+        for (int anchorId : anchorIds)
+        {
+            boxes.push_back(cv::RotatedRect(cv::Point2f(cxRow[anchorId], cyRow[anchorId]),
+                                            cv::Size2f(wRow[anchorId], hRow[anchorId]),
+                                            angles[anchorId] * 180.0f / static_cast<float>(CV_PI)));
+        }
+
+        vector<int> indexes;
+        if (this->useNms)
+        {
+            rotatedNmsBoxesBatched(boxes, confidences, classIds, this->objConf, this->nmsConf, indexes);
+        }
+        else
+        {
+            for (int k = 0; k < boxes.size(); k++)
+            {
+                indexes.push_back(k);
+            }
+        }
+
+        vector<cv::RotatedRect> outputBox;
+        vector<float> outputConfidence;
+        vector<string> outputName;
+        outputBox.reserve(indexes.size());
+        outputConfidence.reserve(indexes.size());
+        outputName.reserve(indexes.size());
+        for (int index : indexes)
+        {
+            outputBox.push_back(boxes.at(index));
+            outputConfidence.push_back(confidences.at(index));
+            outputName.push_back(this->classNames[classIds.at(index)]);
+        }
+        transformers[i].reverse(outputBox);
+
+        outputBoxes.push_back(outputBox);
+        outputConfidences.push_back(outputConfidence);
+        outputNames.push_back(outputName);
+    }
+}
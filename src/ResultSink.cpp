@@ -0,0 +1,223 @@
+#include "ResultSink.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+
+namespace
+{
+/**
+ * @brief 按本机字节序追加一个定长值
+ */
+template <typename T>
+void append(string &record, T value)
+{
+    record.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * @brief 追加JSON字符串（转义引号、反斜杠和控制字符）
+ */
+void appendJsonString(string &record, const string &value)
+{
+    record += '"';
+    for (char c : value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            record += '\\';
+            record += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            record += escaped;
+        }
+        else
+        {
+            record += c;
+        }
+    }
+    record += '"';
+}
+
+/**
+ * @brief 追加JSON数值
+ */
+void appendJsonNumber(string &record, double value)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.6g", value);
+    record += buffer;
+}
+}
+
+ResultSink::ResultSink(const string &path, SinkFormat format, const vector<string> &classNames, bool fifo)
+    : format(format), fifo(fifo), file(nullptr), written(0)
+{
+    for (size_t i = 0; i < classNames.size(); i++)
+    {
+        this->classIds[classNames[i]] = static_cast<int>(i);
+    }
+    if (fifo)
+    {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0 && mkfifo(path.c_str(), 0644) != 0)
+        {
+            std::cerr << "ResultSink: failed to create fifo " << path << ": " << strerror(errno) << std::endl;
+            return;
+        }
+    }
+    this->file = fopen(path.c_str(), format == SINK_JSONL ? "w" : "wb");
+    if (this->file == nullptr)
+    {
+        std::cerr << "ResultSink: failed to open " << path << ": " << strerror(errno) << std::endl;
+        return;
+    }
+    // 文件输出使用较大的缓冲减少系统调用；管道每条记录后刷新，保证读端实时收到
+    setvbuf(this->file, nullptr, _IOFBF, 1 << 20);
+}
+
+ResultSink::~ResultSink()
+{
+    this->close();
+}
+
+bool ResultSink::isOpen() const
+{
+    return this->file != nullptr;
+}
+
+bool ResultSink::write(int stream,
+                       int64_t sequence,
+                       const vector<cv::Rect> &rects,
+                       const vector<string> &names,
+                       const vector<float> &confidences,
+                       const vector<STrack> &tracks)
+{
+    // 编码在锁外完成，锁内只做一次写出
+    string record;
+    if (this->format == SINK_JSONL)
+    {
+        this->encodeJson(stream, sequence, rects, names, confidences, tracks, record);
+    }
+    else
+    {
+        this->encodeBinary(stream, sequence, rects, names, confidences, tracks, record);
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->file == nullptr)
+    {
+        return false;
+    }
+    if (fwrite(record.data(), 1, record.size(), this->file) != record.size())
+    {
+        return false;
+    }
+    if (this->fifo && fflush(this->file) != 0)
+    {
+        return false;
+    }
+    this->written++;
+    return true;
+}
+
+void ResultSink::close()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->file != nullptr)
+    {
+        fclose(this->file);
+        this->file = nullptr;
+    }
+}
+
+uint64_t ResultSink::getWritten() const
+{
+    return this->written.load();
+}
+
+void ResultSink::encodeBinary(int stream,
+                              int64_t sequence,
+                              const vector<cv::Rect> &rects,
+                              const vector<string> &names,
+                              const vector<float> &confidences,
+                              const vector<STrack> &tracks,
+                              string &record)
+{
+    const size_t itemSize = sizeof(int32_t) + 5 * sizeof(float);
+    uint32_t payload = static_cast<uint32_t>(sizeof(int32_t) + sizeof(int64_t) + 2 * sizeof(uint32_t) +
+                                             (rects.size() + tracks.size()) * itemSize);
+    record.reserve(sizeof(uint32_t) + payload);
+    append<uint32_t>(record, payload);
+    append<int32_t>(record, stream);
+    append<int64_t>(record, sequence);
+    append<uint32_t>(record, static_cast<uint32_t>(rects.size()));
+    append<uint32_t>(record, static_cast<uint32_t>(tracks.size()));
+    for (size_t i = 0; i < rects.size(); i++)
+    {
+        append<int32_t>(record, this->classId(names.at(i)));
+        append<float>(record, confidences.at(i));
+        append<float>(record, static_cast<float>(rects[i].x));
+        append<float>(record, static_cast<float>(rects[i].y));
+        append<float>(record, static_cast<float>(rects[i].width));
+        append<float>(record, static_cast<float>(rects[i].height));
+    }
+    for (const STrack &track : tracks)
+    {
+        append<int32_t>(record, track.track_id);
+        append<float>(record, track.score);
+        append<float>(record, track.tlwh[0]);
+        append<float>(record, track.tlwh[1]);
+        append<float>(record, track.tlwh[2]);
+        append<float>(record, track.tlwh[3]);
+    }
+}
+
+void ResultSink::encodeJson(int stream,
+                            int64_t sequence,
+                            const vector<cv::Rect> &rects,
+                            const vector<string> &names,
+                            const vector<float> &confidences,
+                            const vector<STrack> &tracks,
+                            string &record)
+{
+    record += "{\"stream\":" + std::to_string(stream) + ",\"frame\":" + std::to_string(sequence) + ",\"detections\":[";
+    for (size_t i = 0; i < rects.size(); i++)
+    {
+        record += i > 0 ? ",{\"class\":" : "{\"class\":";
+        record += std::to_string(this->classId(names.at(i)));
+        record += ",\"name\":";
+        appendJsonString(record, names.at(i));
+        record += ",\"conf\":";
+        appendJsonNumber(record, confidences.at(i));
+        record += ",\"box\":[" + std::to_string(rects[i].x) + "," + std::to_string(rects[i].y) + "," +
+                  std::to_string(rects[i].width) + "," + std::to_string(rects[i].height) + "]}";
+    }
+    record += "],\"tracks\":[";
+    for (size_t i = 0; i < tracks.size(); i++)
+    {
+        record += i > 0 ? ",{\"id\":" : "{\"id\":";
+        record += std::to_string(tracks[i].track_id);
+        record += ",\"conf\":";
+        appendJsonNumber(record, tracks[i].score);
+        record += ",\"box\":[";
+        for (int k = 0; k < 4; k++)
+        {
+            if (k > 0)
+            {
+                record += ',';
+            }
+            appendJsonNumber(record, tracks[i].tlwh[k]);
+        }
+        record += "]}";
+    }
+    record += "]}\n";
+}
+
+int ResultSink::classId(const string &name) const
+{
+    auto it = this->classIds.find(name);
+    return it == this->classIds.end() ? -1 : it->second;
+}
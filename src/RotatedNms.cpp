@@ -0,0 +1,232 @@
+#include "RotatedNms.h"
+
+/**
+ * @brief 预先计算的旋转框几何信息
+ * 
+ * 顶点按逆时针（有向面积为正）顺序存放，便于直接作为裁剪多边形使用。
+ */
+struct RotatedQuad
+{
+    float x[4];          // 顶点x坐标
+    float y[4];          // 顶点y坐标
+    float minX;          // 外接矩形左边界
+    float minY;          // 外接矩形上边界
+    float maxX;          // 外接矩形右边界
+    float maxY;          // 外接矩形下边界
+    float area;          // 面积
+};
+
+/**
+ * @brief 计算旋转框的顶点、外接矩形和面积
+ * 
+ * @param box 旋转框（角度单位为度，顺时针）
+ * @return RotatedQuad 几何信息
+ */
+static RotatedQuad makeQuad(const cv::RotatedRect &box)
+{
+    RotatedQuad quad;
+    float theta = box.angle * static_cast<float>(CV_PI) / 180.0f;
+    float c = std::cos(theta);
+    float s = std::sin(theta);
+    float ux = 0.5f * box.size.width * c;
+    float uy = 0.5f * box.size.width * s;
+    float vx = -0.5f * box.size.height * s;
+    float vy = 0.5f * box.size.height * c;
+
+    // 顶点顺序 c-u-v, c+u-v, c+u+v, c-u+v，在图像坐标系下有向面积为正
+    const float signU[4] = {-1.0f, 1.0f, 1.0f, -1.0f};
+    const float signV[4] = {-1.0f, -1.0f, 1.0f, 1.0f};
+    for (int k = 0; k < 4; k++)
+    {
+        quad.x[k] = box.center.x + signU[k] * ux + signV[k] * vx;
+        quad.y[k] = box.center.y + signU[k] * uy + signV[k] * vy;
+    }
+
+    quad.minX = std::min(std::min(quad.x[0], quad.x[1]), std::min(quad.x[2], quad.x[3]));
+    quad.maxX = std::max(std::max(quad.x[0], quad.x[1]), std::max(quad.x[2], quad.x[3]));
+    quad.minY = std::min(std::min(quad.y[0], quad.y[1]), std::min(quad.y[2], quad.y[3]));
+    quad.maxY = std::max(std::max(quad.y[0], quad.y[1]), std::max(quad.y[2], quad.y[3]));
+    quad.area = std::abs(box.size.width * box.size.height);
+    return quad;
+}
+
+/**
+ * @brief 用一条有向边裁剪凸多边形（Sutherland-Hodgman 单步）
+ * 
+ * 先对所有顶点一次性计算到边的有向距离（定长数组上的无分支循环），
+ * 再按符号变化拼接输出多边形。
+ * 
+ * @return int 输出多边形顶点数
+ */
+static int clipByEdge(const float *inX, const float *inY, int n,
+                      float ax, float ay, float bx, float by,
+                      float *outX, float *outY)
+{
+    float dist[8];
+    float ex = bx - ax;
+    float ey = by - ay;
+    for (int k = 0; k < n; k++)
+    {
+        dist[k] = ex * (inY[k] - ay) - ey * (inX[k] - ax);
+    }
+
+    int m = 0;
+    for (int k = 0; k < n; k++)
+    {
+        int next = k + 1 == n ? 0 : k + 1;
+        bool inside = dist[k] >= 0.0f;
+        bool nextInside = dist[next] >= 0.0f;
+        if (inside)
+        {
+            outX[m] = inX[k];
+            outY[m] = inY[k];
+            m++;
+        }
+        if (inside != nextInside)
+        {
+            float t = dist[k] / (dist[k] - dist[next]);
+            outX[m] = inX[k] + t * (inX[next] - inX[k]);
+            outY[m] = inY[k] + t * (inY[next] - inY[k]);
+            m++;
+        }
+    }
+    return m;
+}
+
+/**
+ * @brief 计算两个凸四边形的交集面积
+ */
+static float intersectionArea(const RotatedQuad &a, const RotatedQuad &b)
+{
+    // 凸四边形被四条边裁剪后最多8个顶点
+    float bufX[2][8];
+    float bufY[2][8];
+    int n = 4;
+    std::copy(a.x, a.x + 4, bufX[0]);
+    std::copy(a.y, a.y + 4, bufY[0]);
+
+    int cur = 0;
+    for (int e = 0; e < 4 && n > 0; e++)
+    {
+        int next = e + 1 == 4 ? 0 : e + 1;
+        n = clipByEdge(bufX[cur], bufY[cur], n, b.x[e], b.y[e], b.x[next], b.y[next], bufX[1 - cur], bufY[1 - cur]);
+        cur = 1 - cur;
+    }
+    if (n < 3)
+    {
+        return 0.0f;
+    }
+
+    // 鞋带公式求面积
+    float area = 0.0f;
+    for (int k = 0; k < n; k++)
+    {
+        int next = k + 1 == n ? 0 : k + 1;
+        area += bufX[cur][k] * bufY[cur][next] - bufX[cur][next] * bufY[cur][k];
+    }
+    return 0.5f * std::abs(area);
+}
+
+/**
+ * @brief 计算两个已预处理旋转框的交并比
+ * 
+ * @param a 第一个旋转框
+ * @param b 第二个旋转框
+ * @param nmsThreshold 交并比阈值，上界低于该值时直接返回0（小于等于0表示不剪枝）
+ * @return float 交并比
+ */
+static float quadIou(const RotatedQuad &a, const RotatedQuad &b, float nmsThreshold)
+{
+    // 外接矩形不相交
+    float iw = std::min(a.maxX, b.maxX) - std::max(a.minX, b.minX);
+    float ih = std::min(a.maxY, b.maxY) - std::max(a.minY, b.minY);
+    if (iw <= 0.0f || ih <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    // 交集面积不超过外接矩形交集面积，也不超过较小框的面积，据此得到交并比上界
+    float upper = std::min(iw * ih, std::min(a.area, b.area));
+    if (nmsThreshold > 0.0f && upper < nmsThreshold * (a.area + b.area - upper))
+    {
+        return 0.0f;
+    }
+
+    float inter = intersectionArea(a, b);
+    float uni = a.area + b.area - inter;
+    return uni > 0.0f ? inter / uni : 0.0f;
+}
+
+/**
+ * @brief 计算两个旋转框的交并比
+ * 
+ * @param a 第一个旋转框
+ * @param b 第二个旋转框
+ * @return float 交并比
+ */
+float rotatedIou(const cv::RotatedRect &a, const cv::RotatedRect &b)
+{
+    return quadIou(makeQuad(a), makeQuad(b), 0.0f);
+}
+
+/**
+ * @brief 按类别进行旋转框非极大值抑制
+ * 
+ * @param boxes 旋转框列表
+ * @param scores 置信度列表
+ * @param classIds 类别索引列表
+ * @param scoreThreshold 置信度阈值
+ * @param nmsThreshold 交并比阈值
+ * @param indexes 输出保留下来的框索引
+ */
+void rotatedNmsBoxesBatched(const vector<cv::RotatedRect> &boxes,
+                            const vector<float> &scores,
+                            const vector<int> &classIds,
+                            float scoreThreshold,
+                            float nmsThreshold,
+                            vector<int> &indexes)
+{
+    indexes.clear();
+
+    // 置信度过滤并按置信度从高到低排序
+    vector<int> order;
+    order.reserve(boxes.size());
+    for (int i = 0; i < boxes.size(); i++)
+    {
+        if (scores[i] >= scoreThreshold)
+        {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&scores](int a, int b)
+              { return scores[a] > scores[b]; });
+
+    // 每个框的几何信息只计算一次
+    vector<RotatedQuad> quads;
+    quads.reserve(order.size());
+    for (int index : order)
+    {
+        quads.push_back(makeQuad(boxes[index]));
+    }
+
+    vector<char> suppressed(order.size(), 0);
+    for (int i = 0; i < order.size(); i++)
+    {
+        if (suppressed[i])
+        {
+            continue;
+        }
+        indexes.push_back(order[i]);
+        for (int j = i + 1; j < order.size(); j++)
+        {
+            if (suppressed[j] || classIds[order[i]] != classIds[order[j]])
+            {
+                continue;
+            }
+            if (quadIou(quads[i], quads[j], nmsThreshold) > nmsThreshold)
+            {
+                suppressed[j] = 1;
+            }
+        }
+    }
+}
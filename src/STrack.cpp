@@ -1,4 +1,5 @@
 #include "STrack.h"
+#include <atomic>
 
 // 构造函数：根据检测框和置信度初始化STrack对象
 // 参数：tlwh_ - 检测框坐标 [top_left_x, top_left_y, width, height]
@@ -204,13 +205,12 @@ void STrack::mark_removed()
 	state = TrackState::Removed;
 }
 
-// 获取下一个可用的轨迹ID
+// 获取下一个可用的轨迹ID（进程内唯一，多个跟踪器可在不同线程中同时分配）
 // 返回：新的轨迹ID
 int STrack::next_id()
 {
-	static int _count = 0;
-	_count++;
-	return _count;
+	static std::atomic<int> _count(0);
+	return ++_count;
 }
 
 // 获取轨迹结束帧ID
@@ -223,7 +223,8 @@ int STrack::end_frame()
 // 对多个轨迹进行批量预测
 // 参数：stracks - 轨迹列表
 //      kalman_filter - 卡尔曼滤波器实例
-void STrack::multi_predict( std::vector<STrack*> &stracks, byte_kalman::ByteKalmanFilter &kalman_filter)
+//      dt - 时间间隔（以帧为单位）
+void STrack::multi_predict( std::vector<STrack*> &stracks, byte_kalman::ByteKalmanFilter &kalman_filter, float dt)
 {
 	for (int i = 0; i < stracks.size(); i++)
 	{
@@ -233,6 +234,6 @@ void STrack::multi_predict( std::vector<STrack*> &stracks, byte_kalman::ByteKalm
 			stracks[i]->mean[7] = 0;
 		}
 		// 使用卡尔曼滤波器进行预测
-		kalman_filter.predict(stracks[i]->mean, stracks[i]->covariance);
+		kalman_filter.predict(stracks[i]->mean, stracks[i]->covariance, dt);
 	}
 }
\ No newline at end of file
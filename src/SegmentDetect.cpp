@@ -0,0 +1,216 @@
+#include "SegmentDetect.h"
+
+/**
+ * @brief 默认构造函数
+ */
+SegmentDetect::SegmentDetect(/* args */)
+{
+}
+
+/**
+ * @brief 带参数的构造函数，初始化实例分割器
+ * 
+ * 在基础检测器的基础上读取原型掩码尺寸，以及可选的 mask_classes 参数
+ * （以","分隔的类别名称，只对这些类别计算掩码）。
+ * 
+ * @param dir 模型文件所在目录路径
+ */
+SegmentDetect::SegmentDetect(string dir) : Detect(dir)
+{
+    string paramPath = dir + "/param.map";
+    unordered_map<string, string> paramMap = readMap(paramPath);
+    if (paramMap.count("mask_classes"))
+    {
+        for (string name : stringSplit(paramMap["mask_classes"], ","))
+        {
+            this->maskClasses.insert(name);
+        }
+    }
+
+    // 原型掩码输出 [B, M, H, W]
+    vector<int64_t> protoDims = this->model->getOutputNodeDims(1);
+    this->maskDim = static_cast<int>(protoDims.at(1));
+    this->protoHeight = static_cast<int>(protoDims.at(2));
+    this->protoWidth = static_cast<int>(protoDims.at(3));
+
+    // 检测输出 [B, 4+C+M, N]，类别之后的掩码系数在解码时被跳过
+    this->decodeMode = DECODE_CHANNEL_MAJOR;
+}
+
+/**
+ * @brief 执行实例分割预测
+ * 
+ * 先按通道布局解码检测结果并做NMS，再只为保留下来的检测框计算掩码。
+ * 
+ * @param images 输入图像列表
+ * @param outputRects 输出检测框列表
+ * @param outputNames 输出类别名称列表
+ * @param outputConfidences 输出置信度列表
+ * @param outputMasks 输出掩码列表
+ */
+void SegmentDetect::predict(vector<cv::Mat> images,
+                            vector<vector<cv::Rect>> &outputRects,
+                            vector<vector<string>> &outputNames,
+                            vector<vector<float>> &outputConfidences,
+                            vector<vector<cv::Mat>> &outputMasks)
+{
+    // 创建图像变换器和预处理后的图像列表
+    vector<Transformer> transformers;
+    transformers.reserve(images.size());
+    vector<cv::Mat> inputImages;
+    inputImages.reserve(images.size());
+
+    // 对每张图像进行预处理
+    for (cv::Mat image : images)
+    {
+        Transformer transformer(image, this->model->getInputDims().at(2), this->model->getInputDims().at(3));
+        transformer.process();
+        inputImages.push_back(transformer.getInputMat());
+        transformers.push_back(transformer);
+    }
+
+    // 使用模型进行推理
+    vector<vector<cv::Mat>> predicts = this->model->predictOutputs(inputImages);
+
+    const int classNum = static_cast<int>(this->classNames.size());
+    for (int i = 0; i < inputImages.size(); i++)
+    {
+        cv::Mat predict = predicts[0][i];
+        cv::Mat protos = predicts[1][i];
+
+        vector<cv::Rect> boxes;
+        vector<int> classIds;
+        vector<float> confidences;
+        vector<int> anchorIds;
+        this->decodeChannelMajor(predict, boxes, classIds, confidences, &anchorIds);
+
+        vector<int> indexes;
+        if (this->useNms)
+        {
+            cv::dnn::NMSBoxesBatched(boxes, confidences, classIds, this->objConf, this->nmsConf, indexes);
+        }
+        else
+        {
+            for (int k = 0; k < boxes.size(); k++)
+            {
+                indexes.push_back(k);
+            }
+        }
+
+        vector<cv::Rect> inputRect;
+        vector<cv::Rect> outputRect;
+        vector<float> outputConfidence;
+        vector<string> outputName;
+        inputRect.reserve(indexes.size());
+        outputRect.reserve(indexes.size());
+        outputConfidence.reserve(indexes.size());
+        outputName.reserve(indexes.size());
+        for (int index : indexes)
+        {
+            inputRect.push_back(boxes.at(index));
+            outputRect.push_back(boxes.at(index));
+            outputConfidence.push_back(confidences.at(index));
+            outputName.push_back(this->classNames[classIds.at(index)]);
+        }
+        vector<vector<cv::Point>> points;
+        transformers[i].reverse(outputRect, points);
+
+        // 只为保留下来的检测框计算掩码
+        vector<cv::Mat> outputMask(indexes.size());
+        for (int k = 0; k < indexes.size(); k++)
+        {
+            if (!this->maskClasses.empty() && this->maskClasses.count(outputName[k]) == 0)
+            {
+                continue;
+            }
+            // 取出该候选框的掩码系数（位于类别行之后，同一列）
+            cv::Mat coeffs(1, this->maskDim, CV_32F);
+            for (int m = 0; m < this->maskDim; m++)
+            {
+                coeffs.at<float>(0, m) = predict.at<float>(4 + classNum + m, anchorIds[indexes[k]]);
+            }
+            outputMask[k] = this->buildMask(protos, coeffs, inputRect[k], outputRect[k], transformers[i]);
+        }
+
+        outputRects.push_back(outputRect);
+        outputConfidences.push_back(outputConfidence);
+        outputNames.push_back(outputName);
+        outputMasks.push_back(outputMask);
+    }
+}
+
+/**
+ * @brief 计算单个检测框的掩码
+ * 
+ * 1. 将检测框映射到原型分辨率并裁剪出框内区域；
+ * 2. 用一次小矩阵乘法 [1, M] x [M, 裁剪像素数] 得到框内的掩码logit；
+ * 3. 只把框内区域放大到原图尺寸，并以 logit > 0（即 sigmoid > 0.5）二值化。
+ * 
+ * @param protos 原型掩码 [M, H*W]
+ * @param coeffs 掩码系数 [1, M]
+ * @param box 检测框（模型输入坐标系）
+ * @param outputBox 检测框（原图坐标系）
+ * @param transformer 图像变换器
+ * @return cv::Mat 与 outputBox 同尺寸的 CV_8UC1 掩码
+ */
+cv::Mat SegmentDetect::buildMask(const cv::Mat &protos,
+                                 const cv::Mat &coeffs,
+                                 const cv::Rect &box,
+                                 const cv::Rect &outputBox,
+                                 Transformer &transformer)
+{
+    cv::Mat mask = cv::Mat::zeros(std::max(outputBox.height, 1), std::max(outputBox.width, 1), CV_8UC1);
+
+    // 检测框在原型分辨率下的区域
+    float scaleX = static_cast<float>(this->protoWidth) / this->model->getInputDims().at(3);
+    float scaleY = static_cast<float>(this->protoHeight) / this->model->getInputDims().at(2);
+    int x0 = std::max(0, static_cast<int>(std::floor(box.x * scaleX)));
+    int y0 = std::max(0, static_cast<int>(std::floor(box.y * scaleY)));
+    int x1 = std::min(this->protoWidth, static_cast<int>(std::ceil((box.x + box.width) * scaleX)));
+    int y1 = std::min(this->protoHeight, static_cast<int>(std::ceil((box.y + box.height) * scaleY)));
+    if (x1 <= x0 || y1 <= y0)
+    {
+        return mask;
+    }
+    cv::Rect protoRect(x0, y0, x1 - x0, y1 - y0);
+
+    // 裁剪原型掩码：[M, 裁剪像素数]
+    cv::Mat cropped(this->maskDim, protoRect.area(), CV_32F);
+    for (int m = 0; m < this->maskDim; m++)
+    {
+        cv::Mat plane(this->protoHeight, this->protoWidth, CV_32F, const_cast<float *>(protos.ptr<float>(m)));
+        cv::Mat dst(protoRect.height, protoRect.width, CV_32F, cropped.ptr<float>(m));
+        plane(protoRect).copyTo(dst);
+    }
+
+    // 掩码logit [1, 裁剪像素数] -> [裁剪高度, 裁剪宽度]
+    cv::Mat logits = coeffs * cropped;
+    logits = logits.reshape(1, protoRect.height);
+
+    // 裁剪区域对应的原图区域
+    vector<cv::Rect> cropRects;
+    cropRects.push_back(cv::Rect(static_cast<int>(x0 / scaleX),
+                                 static_cast<int>(y0 / scaleY),
+                                 static_cast<int>(protoRect.width / scaleX),
+                                 static_cast<int>(protoRect.height / scaleY)));
+    vector<vector<cv::Point>> points;
+    transformer.reverse(cropRects, points);
+    cv::Rect cropRect = cropRects[0];
+    if (cropRect.width <= 0 || cropRect.height <= 0)
+    {
+        return mask;
+    }
+
+    // 只放大框内区域并二值化
+    cv::Mat resized;
+    cv::resize(logits, resized, cv::Size(cropRect.width, cropRect.height), 0, 0, cv::INTER_LINEAR);
+    cv::Rect boxRegion(0, 0, mask.cols, mask.rows);
+    cv::Rect overlap = (cropRect - outputBox.tl()) & boxRegion;
+    if (overlap.empty())
+    {
+        return mask;
+    }
+    cv::Mat binary = resized(overlap - (cropRect.tl() - outputBox.tl())) > 0;
+    binary.copyTo(mask(overlap));
+    return mask;
+}
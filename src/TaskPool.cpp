@@ -0,0 +1,237 @@
+#include "TaskPool.h"
+#include <exception>
+#include <iomanip>
+#include <sstream>
+#include "Include.h"
+
+namespace
+{
+// 调用线程所属的池和下标，用于识别池内提交与嵌套调用
+thread_local const TaskPool *currentPool = nullptr;
+thread_local int currentWorker = -1;
+
+/**
+ * @brief 一次 parallelFor 的共享状态
+ */
+struct ForState
+{
+    explicit ForState(size_t count) : remaining(count)
+    {
+    }
+
+    std::atomic<size_t> remaining;      // 未完成的下标数
+    std::mutex errorMutex;              // 保护 error
+    std::exception_ptr error;           // 第一个异常
+    EventCount done;                    // 全部完成事件
+};
+}
+
+TaskPool::TaskPool(int workerNum, const std::vector<int> &cpus)
+    : cpus(cpus), pending(0), stopping(false), nextWorker(0), executed(0), stolen(0)
+{
+    workerNum = std::max(1, workerNum);
+    for (int i = 0; i < workerNum; i++)
+    {
+        this->workers.emplace_back(new Worker());
+    }
+    for (int i = 0; i < workerNum; i++)
+    {
+        this->workers[i]->thread = std::thread(&TaskPool::run, this, i);
+    }
+}
+
+TaskPool::~TaskPool()
+{
+    this->stopping.store(true);
+    this->event.notifyAll();
+    for (const std::unique_ptr<Worker> &worker : this->workers)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+}
+
+void TaskPool::submit(Task task)
+{
+    int self = this->currentIndex();
+    size_t index = self >= 0 ? static_cast<size_t>(self) : this->nextWorker.fetch_add(1) % this->workers.size();
+    {
+        std::lock_guard<std::mutex> lock(this->workers[index]->mutex);
+        this->workers[index]->tasks.push_back(std::move(task));
+    }
+    this->pending.fetch_add(1);
+    this->event.notifyOne();
+}
+
+void TaskPool::parallelFor(size_t count, const std::function<void(size_t)> &body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    std::shared_ptr<ForState> state = std::make_shared<ForState>(count);
+    auto execute = [state, &body](size_t i) {
+        try
+        {
+            body(i);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(state->errorMutex);
+            if (!state->error)
+            {
+                state->error = std::current_exception();
+            }
+        }
+        if (state->remaining.fetch_sub(1) == 1)
+        {
+            state->done.notifyAll();
+        }
+    };
+    // body 的引用在全部下标完成前始终有效：调用线程会等到 remaining 归零才返回
+    for (size_t i = 1; i < count; i++)
+    {
+        this->submit([execute, i]() { execute(i); });
+    }
+    execute(0);
+
+    int self = this->currentIndex();
+    while (state->remaining.load() > 0)
+    {
+        // 等待期间帮忙执行任务，避免池内调用时所有线程互相等待
+        if (this->runOne(self))
+        {
+            continue;
+        }
+        uint32_t key = state->done.prepareWait();
+        if (state->remaining.load() == 0)
+        {
+            state->done.cancelWait();
+            break;
+        }
+        // 剩余下标正在其它线程执行，短暂等待后再检查是否有新任务可帮忙
+        state->done.wait(key, 200);
+    }
+    if (state->error)
+    {
+        std::rethrow_exception(state->error);
+    }
+}
+
+int TaskPool::getWorkerNum() const
+{
+    return static_cast<int>(this->workers.size());
+}
+
+uint64_t TaskPool::getExecuted() const
+{
+    return this->executed.load();
+}
+
+uint64_t TaskPool::getStolen() const
+{
+    return this->stolen.load();
+}
+
+std::string TaskPool::report() const
+{
+    uint64_t executed = this->getExecuted();
+    uint64_t stolen = this->getStolen();
+    std::ostringstream out;
+    out << std::left << std::setw(12) << "taskpool"
+        << " workers=" << this->getWorkerNum()
+        << " tasks=" << executed
+        << " stolen=" << stolen
+        << " (" << std::fixed << std::setprecision(1) << (executed > 0 ? 100.0 * stolen / executed : 0.0) << "%)"
+        << std::endl;
+    return out.str();
+}
+
+void TaskPool::run(int index)
+{
+    currentPool = this;
+    currentWorker = index;
+    if (!this->cpus.empty() && !pinCurrentThread(this->cpus))
+    {
+        std::cerr << "TaskPool: failed to pin worker " << index << std::endl;
+    }
+    while (true)
+    {
+        if (this->runOne(index))
+        {
+            continue;
+        }
+        uint32_t key = this->event.prepareWait();
+        if (this->pending.load() > 0)
+        {
+            this->event.cancelWait();
+            continue;
+        }
+        if (this->stopping.load())
+        {
+            this->event.cancelWait();
+            break;
+        }
+        this->event.wait(key);
+    }
+}
+
+bool TaskPool::runOne(int self)
+{
+    if (this->pending.load() <= 0)
+    {
+        return false;
+    }
+    Task task;
+    bool steal = false;
+    if (self >= 0)
+    {
+        Worker &worker = *this->workers[self];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.tasks.empty())
+        {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        }
+    }
+    if (!task)
+    {
+        size_t workerNum = this->workers.size();
+        size_t start = self >= 0 ? static_cast<size_t>(self) + 1 : this->nextWorker.load();
+        for (size_t offset = 0; offset < workerNum && !task; offset++)
+        {
+            size_t index = (start + offset) % workerNum;
+            if (static_cast<int>(index) == self)
+            {
+                continue;
+            }
+            Worker &victim = *this->workers[index];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                steal = true;
+            }
+        }
+    }
+    if (!task)
+    {
+        return false;
+    }
+    this->pending.fetch_sub(1);
+    task();
+    this->executed.fetch_add(1);
+    if (steal)
+    {
+        this->stolen.fetch_add(1);
+    }
+    return true;
+}
+
+int TaskPool::currentIndex() const
+{
+    return currentPool == this ? currentWorker : -1;
+}
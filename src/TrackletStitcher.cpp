@@ -0,0 +1,210 @@
+#include "TrackletStitcher.h"
+#include <algorithm>
+#include <limits>
+#include <set>
+
+namespace
+{
+/**
+ * @brief 一对候选匹配
+ */
+struct Candidate
+{
+    float iou;                      // 平均IoU
+    int common;                     // 共同帧数
+    size_t previous;                // 前一分段轨迹下标
+    size_t next;                    // 后一分段轨迹下标
+};
+}
+
+TrackletStitcher::TrackletStitcher(const Options &options)
+    : options(options), overlapLinks(0), gapLinks(0), globalTracks(0)
+{
+}
+
+std::vector<TrackRecord> TrackletStitcher::stitch(const std::vector<std::vector<TrackRecord>> &segments,
+                                                  const std::vector<Handover> &handovers)
+{
+    this->overlapLinks = 0;
+    this->gapLinks = 0;
+    this->globalTracks = 0;
+
+    std::vector<TrackRecord> stitched;
+    std::vector<Tracklet> previous;
+    std::map<int, int> previousGlobal;      // 前一分段ID -> 全局ID
+    for (size_t s = 0; s < segments.size(); s++)
+    {
+        std::vector<Tracklet> tracklets = group(segments[s]);
+        std::map<int, int> global;
+        if (s > 0 && s - 1 < handovers.size())
+        {
+            std::map<int, int> links = this->match(previous, tracklets, handovers[s - 1]);
+            for (const auto &link : links)
+            {
+                // 前一分段的轨迹只出现在交接帧之后时尚未分配全局ID
+                auto found = previousGlobal.find(link.second);
+                global[link.first] = found != previousGlobal.end() ? found->second : ++this->globalTracks;
+            }
+        }
+
+        // 只输出本分段负责的帧：上一个交接帧到下一个交接帧之前
+        int64_t begin = s > 0 && s - 1 < handovers.size() ? handovers[s - 1].frame : std::numeric_limits<int64_t>::min();
+        int64_t end = s < handovers.size() ? handovers[s].frame : std::numeric_limits<int64_t>::max();
+        for (const TrackRecord &record : segments[s])
+        {
+            if (record.frame < begin || record.frame >= end)
+            {
+                continue;
+            }
+            auto found = global.find(record.id);
+            if (found == global.end())
+            {
+                found = global.insert(std::make_pair(record.id, ++this->globalTracks)).first;
+            }
+            TrackRecord output = record;
+            output.id = found->second;
+            stitched.push_back(output);
+        }
+        previous.swap(tracklets);
+        previousGlobal.swap(global);
+    }
+    std::stable_sort(stitched.begin(), stitched.end(),
+                     [](const TrackRecord &a, const TrackRecord &b) { return a.frame < b.frame; });
+    return stitched;
+}
+
+int TrackletStitcher::getOverlapLinks() const
+{
+    return this->overlapLinks;
+}
+
+int TrackletStitcher::getGapLinks() const
+{
+    return this->gapLinks;
+}
+
+int TrackletStitcher::getGlobalTracks() const
+{
+    return this->globalTracks;
+}
+
+std::vector<TrackletStitcher::Tracklet> TrackletStitcher::group(const std::vector<TrackRecord> &records)
+{
+    std::vector<Tracklet> tracklets;
+    std::map<int, size_t> index;
+    for (const TrackRecord &record : records)
+    {
+        auto found = index.find(record.id);
+        if (found == index.end())
+        {
+            found = index.insert(std::make_pair(record.id, tracklets.size())).first;
+            tracklets.push_back(Tracklet());
+            tracklets.back().id = record.id;
+        }
+        tracklets[found->second].boxes[record.frame] = record.box;
+    }
+    return tracklets;
+}
+
+float TrackletStitcher::iou(const cv::Rect_<float> &a, const cv::Rect_<float> &b)
+{
+    float intersection = (a & b).area();
+    float joined = a.area() + b.area() - intersection;
+    return joined > 0 ? intersection / joined : 0.f;
+}
+
+std::map<int, int> TrackletStitcher::match(const std::vector<Tracklet> &previous,
+                                           const std::vector<Tracklet> &next,
+                                           const Handover &handover)
+{
+    // 重叠窗口内两个分段对同一帧各有跟踪框，同一目标的框几乎重合
+    std::vector<Candidate> candidates;
+    for (size_t a = 0; a < previous.size(); a++)
+    {
+        for (size_t b = 0; b < next.size(); b++)
+        {
+            float sum = 0.f;
+            int common = 0;
+            auto first = next[b].boxes.lower_bound(handover.overlapBegin);
+            auto last = next[b].boxes.lower_bound(handover.frame);
+            for (auto it = first; it != last; ++it)
+            {
+                auto other = previous[a].boxes.find(it->first);
+                if (other != previous[a].boxes.end())
+                {
+                    sum += iou(other->second, it->second);
+                    common++;
+                }
+            }
+            if (common >= this->options.minFrames && sum / common >= this->options.iou)
+            {
+                candidates.push_back(Candidate{sum / common, common, a, b});
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &x, const Candidate &y) {
+        return x.iou != y.iou ? x.iou > y.iou : x.common > y.common;
+    });
+
+    std::map<int, int> links;
+    std::set<size_t> usedPrevious;
+    std::set<size_t> usedNext;
+    for (const Candidate &candidate : candidates)
+    {
+        if (usedPrevious.count(candidate.previous) || usedNext.count(candidate.next))
+        {
+            continue;
+        }
+        usedPrevious.insert(candidate.previous);
+        usedNext.insert(candidate.next);
+        links[next[candidate.next].id] = previous[candidate.previous].id;
+        this->overlapLinks++;
+    }
+
+    // 没有共同帧的轨迹：前一分段在重叠窗口附近结束、后一分段随后不久开始，且首尾框重合
+    candidates.clear();
+    for (size_t a = 0; a < previous.size(); a++)
+    {
+        if (usedPrevious.count(a) || previous[a].boxes.empty())
+        {
+            continue;
+        }
+        const auto &tail = *previous[a].boxes.rbegin();
+        if (tail.first < handover.overlapBegin - this->options.maxGap)
+        {
+            continue;
+        }
+        for (size_t b = 0; b < next.size(); b++)
+        {
+            if (usedNext.count(b) || next[b].boxes.empty())
+            {
+                continue;
+            }
+            const auto &head = *next[b].boxes.begin();
+            int64_t gap = head.first - tail.first;
+            if (gap <= 0 || gap > this->options.maxGap)
+            {
+                continue;
+            }
+            float overlap = iou(tail.second, head.second);
+            if (overlap >= this->options.iou)
+            {
+                candidates.push_back(Candidate{overlap, 0, a, b});
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate &x, const Candidate &y) { return x.iou > y.iou; });
+    for (const Candidate &candidate : candidates)
+    {
+        if (usedPrevious.count(candidate.previous) || usedNext.count(candidate.next))
+        {
+            continue;
+        }
+        usedPrevious.insert(candidate.previous);
+        usedNext.insert(candidate.next);
+        links[next[candidate.next].id] = previous[candidate.previous].id;
+        this->gapLinks++;
+    }
+    return links;
+}
@@ -36,6 +36,22 @@ Transformer::Transformer(cv::Mat image, int normalizeHeight, int normalizeWidth)
     this->normalizeWidth = normalizeWidth;
 }
 
+/**
+ * @brief 构造函数，使用解码时已按letterbox比例缩放的图像
+ * 
+ * @param image 已缩放的输入图像
+ * @param normalizeHeight 目标归一化高度
+ * @param normalizeWidth 目标归一化宽度
+ * @param sourceSize 缩放前的原始尺寸
+ */
+Transformer::Transformer(cv::Mat image, int normalizeHeight, int normalizeWidth, cv::Size sourceSize)
+{
+    this->oriImage = image;
+    this->normalizeHeight = normalizeHeight;
+    this->normalizeWidth = normalizeWidth;
+    this->sourceSize = sourceSize;
+}
+
 /**
  * @brief 图像预处理
  * 
@@ -48,9 +64,10 @@ Transformer::Transformer(cv::Mat image, int normalizeHeight, int normalizeWidth)
  */
 void Transformer::process()
 {
-    // 获取原始图像尺寸
-    float imgHeight = static_cast<float>(this->oriImage.size().height);
-    float imgWidth = static_cast<float>(this->oriImage.size().width);
+    // 获取原始图像尺寸（解码时已缩放则为缩放前的尺寸）
+    cv::Size size = this->sourceSize.area() > 0 ? this->sourceSize : this->oriImage.size();
+    float imgHeight = static_cast<float>(size.height);
+    float imgWidth = static_cast<float>(size.width);
 
     // 计算缩放比例，保持宽高比不变
     this->resizeRatio = std::min(static_cast<float>(this->normalizeHeight) / imgHeight,
@@ -64,17 +81,25 @@ void Transformer::process()
     float dw = (float)(this->normalizeWidth - resize_w) / 2.0f;
     float dh = (float)(this->normalizeHeight - resize_h) / 2.0f;
 
-    // 缩放图像
-    resize(this->oriImage, this->normalizeImage, cv::Size(resize_w, resize_h));
-
     // 计算填充边框的像素数
     this->top = int(std::round(dh - 0.1f));
     this->bottom = int(std::round(dh + 0.1f));
     this->left = int(std::round(dw - 0.1f));
     this->right = int(std::round(dw + 0.1f));
 
-    // 在图像周围填充边框（使用灰色填充）
-    cv::copyMakeBorder(this->normalizeImage, this->normalizeImage, top, bottom, left, right, cv::BORDER_CONSTANT, 128);
+    if (this->oriImage.size() == cv::Size(resize_w, resize_h))
+    {
+        // 解码时已缩放到目标尺寸，直接填充边框（写入新的缓冲，不修改原图）
+        cv::copyMakeBorder(this->oriImage, this->normalizeImage, top, bottom, left, right, cv::BORDER_CONSTANT, 128);
+    }
+    else
+    {
+        // 缩放图像
+        resize(this->oriImage, this->normalizeImage, cv::Size(resize_w, resize_h));
+
+        // 在图像周围填充边框（使用灰色填充）
+        cv::copyMakeBorder(this->normalizeImage, this->normalizeImage, top, bottom, left, right, cv::BORDER_CONSTANT, 128);
+    }
 
     // 将图像转换为模型输入格式（归一化、调整通道顺序等）
     cv::dnn::blobFromImage(this->normalizeImage,
@@ -119,6 +144,25 @@ void Transformer::reverse(std::vector<cv::Rect> &boxes,
     }
 }
 
+/**
+ * @brief 旋转框坐标反变换
+ * 
+ * letterbox只包含等比缩放和平移，因此旋转框的中心点去除填充后按比例缩放，
+ * 宽高按比例缩放，角度保持不变。
+ * 
+ * @param boxes 旋转框（输入输出参数）
+ */
+void Transformer::reverse(std::vector<cv::RotatedRect> &boxes)
+{
+    for (cv::RotatedRect &box : boxes)
+    {
+        box.center.x = (box.center.x - this->left) / this->resizeRatio;
+        box.center.y = (box.center.y - this->top) / this->resizeRatio;
+        box.size.width = box.size.width / this->resizeRatio;
+        box.size.height = box.size.height / this->resizeRatio;
+    }
+}
+
 /**
  * @brief 获取归一化图像
  * 
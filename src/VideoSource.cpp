@@ -0,0 +1,262 @@
+#include "VideoSource.h"
+#include <algorithm>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+}
+
+cv::Size letterboxSize(const cv::Size &source, const cv::Size &target)
+{
+    float ratio = std::min(static_cast<float>(target.height) / static_cast<float>(source.height),
+                           static_cast<float>(target.width) / static_cast<float>(source.width));
+    return cv::Size(int(ratio * source.width), int(ratio * source.height));
+}
+
+VideoSource::VideoSource()
+    : format(nullptr), codec(nullptr), sws(nullptr), frame(nullptr), packet(nullptr),
+      streamIndex(-1), draining(false), skip(DECODE_ALL), fps(0.0), timeBase(0.0), timestamp(0.0), decoded(0)
+{
+}
+
+VideoSource::~VideoSource()
+{
+    this->release();
+}
+
+bool VideoSource::open(const string &path, const Options &options)
+{
+    this->release();
+    if (avformat_open_input(&this->format, path.c_str(), nullptr, nullptr) < 0)
+    {
+        return false;
+    }
+    if (avformat_find_stream_info(this->format, nullptr) < 0)
+    {
+        this->release();
+        return false;
+    }
+    this->streamIndex = av_find_best_stream(this->format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (this->streamIndex < 0)
+    {
+        this->release();
+        return false;
+    }
+    AVStream *stream = this->format->streams[this->streamIndex];
+    const AVCodec *decoder = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (decoder == nullptr)
+    {
+        this->release();
+        return false;
+    }
+    this->codec = avcodec_alloc_context3(decoder);
+    if (this->codec == nullptr || avcodec_parameters_to_context(this->codec, stream->codecpar) < 0)
+    {
+        this->release();
+        return false;
+    }
+    // 帧级和片级多线程解码，由解码器选择可用的方式
+    this->codec->thread_count = std::max(0, options.threads);
+    this->codec->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    this->skip = options.skip;
+    if (options.skip == DECODE_SKIP_NONREF)
+    {
+        this->codec->skip_frame = AVDISCARD_NONREF;
+    }
+    else if (options.skip == DECODE_KEYFRAMES)
+    {
+        this->codec->skip_frame = AVDISCARD_NONKEY;
+    }
+    if (avcodec_open2(this->codec, decoder, nullptr) < 0)
+    {
+        this->release();
+        return false;
+    }
+
+    this->frame = av_frame_alloc();
+    this->packet = av_packet_alloc();
+    AVRational rate = av_guess_frame_rate(this->format, stream, nullptr);
+    this->fps = rate.num > 0 && rate.den > 0 ? av_q2d(rate) : 0.0;
+    this->timeBase = av_q2d(stream->time_base);
+    this->timestamp = 0.0;
+    this->sourceSize = cv::Size(this->codec->width, this->codec->height);
+    this->outputSize = options.outputSize.area() > 0 ? options.outputSize : this->sourceSize;
+    this->draining = false;
+    this->decoded.store(0);
+    return this->frame != nullptr && this->packet != nullptr;
+}
+
+bool VideoSource::isOpened() const
+{
+    return this->codec != nullptr;
+}
+
+bool VideoSource::read(cv::Mat &image)
+{
+    if (!this->isOpened() || !this->decodeNext())
+    {
+        return false;
+    }
+    // 源像素格式或尺寸在流中途变化时重建转换上下文
+    this->sws = sws_getCachedContext(this->sws,
+                                     this->frame->width, this->frame->height, static_cast<AVPixelFormat>(this->frame->format),
+                                     this->outputSize.width, this->outputSize.height, AV_PIX_FMT_BGR24,
+                                     SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (this->sws == nullptr)
+    {
+        return false;
+    }
+    image.create(this->outputSize, CV_8UC3);
+    uint8_t *data[4] = {image.data, nullptr, nullptr, nullptr};
+    int linesize[4] = {static_cast<int>(image.step[0]), 0, 0, 0};
+    sws_scale(this->sws, this->frame->data, this->frame->linesize, 0, this->frame->height, data, linesize);
+    int64_t pts = this->frame->best_effort_timestamp;
+    if (pts != AV_NOPTS_VALUE && this->timeBase > 0)
+    {
+        this->timestamp = pts * this->timeBase;
+    }
+    else if (this->fps > 0)
+    {
+        this->timestamp = this->decoded.load() / this->fps;
+    }
+    av_frame_unref(this->frame);
+    this->decoded.fetch_add(1);
+    return true;
+}
+
+bool VideoSource::seek(double seconds)
+{
+    if (!this->isOpened() || this->timeBase <= 0)
+    {
+        return false;
+    }
+    int64_t target = static_cast<int64_t>(seconds / this->timeBase);
+    if (av_seek_frame(this->format, this->streamIndex, target, AVSEEK_FLAG_BACKWARD) < 0)
+    {
+        return false;
+    }
+    // 丢弃解码器中定位前缓存的帧
+    avcodec_flush_buffers(this->codec);
+    this->draining = false;
+    return true;
+}
+
+bool VideoSource::probeKeyframes(const string &path, std::vector<double> &keyframes, double &duration)
+{
+    keyframes.clear();
+    duration = 0.0;
+    AVFormatContext *format = nullptr;
+    if (avformat_open_input(&format, path.c_str(), nullptr, nullptr) < 0)
+    {
+        return false;
+    }
+    int index = -1;
+    if (avformat_find_stream_info(format, nullptr) >= 0)
+    {
+        index = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    }
+    if (index < 0)
+    {
+        avformat_close_input(&format);
+        return false;
+    }
+    double timeBase = av_q2d(format->streams[index]->time_base);
+    AVPacket *packet = av_packet_alloc();
+    while (packet != nullptr && av_read_frame(format, packet) >= 0)
+    {
+        if (packet->stream_index == index && packet->pts != AV_NOPTS_VALUE)
+        {
+            double time = packet->pts * timeBase;
+            if (packet->flags & AV_PKT_FLAG_KEY)
+            {
+                keyframes.push_back(time);
+            }
+            duration = std::max(duration, time + packet->duration * timeBase);
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+    avformat_close_input(&format);
+    std::sort(keyframes.begin(), keyframes.end());
+    return true;
+}
+
+void VideoSource::setOutputSize(const cv::Size &size)
+{
+    this->outputSize = size.area() > 0 ? size : this->sourceSize;
+}
+
+void VideoSource::release()
+{
+    if (this->sws != nullptr)
+    {
+        sws_freeContext(this->sws);
+        this->sws = nullptr;
+    }
+    av_frame_free(&this->frame);
+    av_packet_free(&this->packet);
+    avcodec_free_context(&this->codec);
+    avformat_close_input(&this->format);
+    this->streamIndex = -1;
+}
+
+double VideoSource::getFps() const
+{
+    return this->fps;
+}
+
+double VideoSource::getTimestamp() const
+{
+    return this->timestamp;
+}
+
+cv::Size VideoSource::getSourceSize() const
+{
+    return this->sourceSize;
+}
+
+cv::Size VideoSource::getOutputSize() const
+{
+    return this->outputSize;
+}
+
+uint64_t VideoSource::getDecoded() const
+{
+    return this->decoded.load();
+}
+
+bool VideoSource::decodeNext()
+{
+    while (true)
+    {
+        int ret = avcodec_receive_frame(this->codec, this->frame);
+        if (ret == 0)
+        {
+            return true;
+        }
+        if (ret != AVERROR(EAGAIN) || this->draining)
+        {
+            return false;
+        }
+
+        // 解码器需要更多输入：读取下一个视频包
+        ret = av_read_frame(this->format, this->packet);
+        if (ret < 0)
+        {
+            // 文件结束，送入结束标记取出解码器中缓存的帧
+            this->draining = true;
+            avcodec_send_packet(this->codec, nullptr);
+            continue;
+        }
+        bool wanted = this->packet->stream_index == this->streamIndex &&
+                      (this->skip != DECODE_KEYFRAMES || (this->packet->flags & AV_PKT_FLAG_KEY));
+        if (wanted)
+        {
+            avcodec_send_packet(this->codec, this->packet);
+        }
+        av_packet_unref(this->packet);
+    }
+}